@@ -0,0 +1,89 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace JackDistortion {
+
+//------------------------------------------------------------------------------------------------------------//
+// Watches how much of each block's real-time budget processBlock uses and decides how many quality
+// tiers to drop. Load is the time spent over the time the block lasts at the sample rate, smoothed
+// over roughly a quarter of a second. A sustained overload drops a step at once; headroom must
+// last much longer before a step comes back, and every drop doubles that wait, so a machine that
+// is only just too slow settles on the lower tier instead of bouncing between the two.
+class AdaptiveQuality
+{
+public:
+    static constexpr float overloadThreshold = 0.7f;   // share of the budget
+    static constexpr float headroomThreshold = 0.35f;
+    static constexpr double overloadSeconds = 0.25;
+    static constexpr double headroomSeconds = 2.0;
+    static constexpr double maxHeadroomSeconds = 30.0;
+
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        reset();
+    }
+
+    void reset()
+    {
+        load = 0.0f;
+        stepsDown = 0;
+        overloadedFor = headroomFor = 0.0;
+        requiredHeadroom = headroomSeconds;
+    }
+
+    /** Feeds the time one block took. Returns true when the number of steps down changed. */
+    bool update(double secondsTaken, int numSamples)
+    {
+        if (sampleRate <= 0.0 || numSamples <= 0)
+            return false;
+
+        const double blockSeconds = numSamples / sampleRate;
+        const float blockLoad = static_cast<float>(secondsTaken / blockSeconds);
+        const float smoothing = static_cast<float>(1.0 - std::exp(-blockSeconds / loadSmoothingSeconds));
+        load += (blockLoad - load) * smoothing;
+
+        overloadedFor = load > overloadThreshold ? overloadedFor + blockSeconds : 0.0;
+        headroomFor   = load < headroomThreshold ? headroomFor + blockSeconds : 0.0;
+
+        if (overloadedFor >= overloadSeconds && stepsDown < maxStepsDown)
+        {
+            ++stepsDown;
+            requiredHeadroom = juce::jmin(maxHeadroomSeconds, requiredHeadroom * 2.0);
+            overloadedFor = headroomFor = 0.0;
+            return true;
+        }
+
+        if (headroomFor >= requiredHeadroom && stepsDown > 0)
+        {
+            --stepsDown;
+            overloadedFor = headroomFor = 0.0;
+            return true;
+        }
+
+        return false;
+    }
+
+    /** Limits the drop, e.g. to the number of tiers below the requested one. */
+    void setMaxStepsDown(int newMaxStepsDown) noexcept
+    {
+        maxStepsDown = newMaxStepsDown;
+        stepsDown = juce::jmin(stepsDown, maxStepsDown);
+    }
+
+    int getStepsDown() const noexcept { return stepsDown; }
+    float getLoad() const noexcept    { return load; }
+
+private:
+    static constexpr double loadSmoothingSeconds = 0.25;
+
+    double sampleRate = 0.0;
+    int maxStepsDown = 0;
+    float load = 0.0f;
+    int stepsDown = 0;
+    double overloadedFor = 0.0, headroomFor = 0.0;
+    double requiredHeadroom = headroomSeconds;
+};
+
+} // namespace JackDistortion
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace JackDistortion {
+
+//------------------------------------------------------------------------------------------------------------//
+// Linear smoother with the same behaviour as juce::SmoothedValue<float>, but rendered a block at a
+// time. fillRamp() writes the values a run of getNextValue() calls would have produced in one
+// vectorisable pass, and isSettled() lets the caller use getCurrentValue() as a constant instead.
+class BlockSmoothedValue
+{
+public:
+    void reset(double sampleRate, double rampLengthInSeconds)
+    {
+        jassert(sampleRate > 0 && rampLengthInSeconds >= 0);
+        stepsToTarget = static_cast<int>(std::floor(rampLengthInSeconds * sampleRate));
+        setCurrentAndTargetValue(target);
+    }
+
+    void setCurrentAndTargetValue(float newValue)
+    {
+        target = current = newValue;
+        countdown = 0;
+    }
+
+    void setTargetValue(float newValue)
+    {
+        if (newValue == target)
+            return;
+
+        if (stepsToTarget <= 0)
+        {
+            setCurrentAndTargetValue(newValue);
+            return;
+        }
+
+        target = newValue;
+        countdown = stepsToTarget;
+        step = (target - current) / static_cast<float>(countdown);
+    }
+
+    float getCurrentValue() const noexcept { return current; }
+    float getTargetValue() const noexcept  { return target; }
+    bool isSmoothing() const noexcept      { return countdown > 0; }
+    bool isSettled() const noexcept        { return countdown <= 0; }
+
+    float getNextValue()
+    {
+        if (countdown <= 0)
+            return target;
+
+        --countdown;
+        current = countdown > 0 ? current + step : target;
+        return current;
+    }
+
+    float skip(int numSamples)
+    {
+        if (numSamples >= countdown)
+        {
+            setCurrentAndTargetValue(target);
+            return target;
+        }
+
+        current += step * static_cast<float>(numSamples);
+        countdown -= numSamples;
+        return current;
+    }
+
+    /** Writes the next numSamples values and advances past them. */
+    void fillRamp(float* destination, int numSamples)
+    {
+        const int rampLength = juce::jmin(numSamples, countdown);
+        const float start = current;
+
+        for (int i = 0; i < rampLength; ++i)
+            destination[i] = start + step * static_cast<float>(i + 1);
+
+        if (rampLength > 0 && rampLength == countdown)
+            destination[rampLength - 1] = target;
+
+        if (rampLength < numSamples)
+            juce::FloatVectorOperations::fill(destination + rampLength, target, numSamples - rampLength);
+
+        skip(numSamples);
+    }
+
+private:
+    float current = 0.0f, target = 0.0f, step = 0.0f;
+    int countdown = 0, stepsToTarget = 0;
+};
+
+} // namespace JackDistortion
@@ -72,30 +72,10 @@ float LFOdsp::processModulation()
         wrapped = true;
     }
     
-    float lfoValue = 0.0f;
-    switch (waveformType)
-    {
-        case 0: // Sine
-            lfoValue = std::sin(phase);
-            break;
-        case 1: // Triangle
-            lfoValue = (2.0f / juce::MathConstants<float>::pi) * std::asin(std::sin(phase));
-            break;
-        case 2: // Square
-            lfoValue = (phase < juce::MathConstants<float>::pi) ? 1.0f : -1.0f;
-            break;
-        case 3: // Saw
-            lfoValue = (2.0f * phase / juce::MathConstants<float>::twoPi) - 1.0f;
-            break;
-        case 4: // Random sample & hold
-            if (wrapped)
-                lastRandomValue = randomGenerator.nextFloat() * 2.0f - 1.0f;  // New random value in [-1, 1]
-            lfoValue = lastRandomValue;
-            break;
-        default:
-            lfoValue = 1.0f;
-    }
+    if (wrapped && waveformType == 4) // Random sample & hold
+        lastRandomValue = randomGenerator.nextFloat() * 2.0f - 1.0f;  // New random value in [-1, 1]
     
+    float lfoValue = getWaveformValue();
     lfoValue *= (depth * 0.5f);
     currentModulation = lfoValue;
     
@@ -106,6 +86,51 @@ float LFOdsp::processModulation()
     return lfoValue;
 }
 
+void LFOdsp::advance(int numSamples)
+{
+    for (int start = 0; start < numSamples; start += advanceDisplayStep)
+    {
+        const int num = juce::jmin(advanceDisplayStep, numSamples - start);
+        
+        phase += phaseIncrement * num;
+        while (phase > juce::MathConstants<double>::twoPi)
+        {
+            phase -= juce::MathConstants<double>::twoPi;
+            if (waveformType == 4)
+                lastRandomValue = randomGenerator.nextFloat() * 2.0f - 1.0f;
+        }
+        
+        const float lfoValue = getWaveformValue() * (depth * 0.5f);
+        currentModulation = lfoValue;
+        
+        // Hold the value across the step in the display buffer.
+        int index = writeIndex.load(std::memory_order_relaxed);
+        const int firstPart = juce::jmin(num, bufferSize - index);
+        std::fill(lfoBuffer.begin() + index, lfoBuffer.begin() + index + firstPart, lfoValue);
+        std::fill(lfoBuffer.begin(), lfoBuffer.begin() + (num - firstPart), lfoValue);
+        writeIndex.store((index + num) % bufferSize, std::memory_order_relaxed);
+    }
+}
+
+float LFOdsp::getWaveformValue() const
+{
+    switch (waveformType)
+    {
+        case 0: // Sine
+            return static_cast<float>(std::sin(phase));
+        case 1: // Triangle
+            return static_cast<float>((2.0f / juce::MathConstants<float>::pi) * std::asin(std::sin(phase)));
+        case 2: // Square
+            return (phase < juce::MathConstants<float>::pi) ? 1.0f : -1.0f;
+        case 3: // Saw
+            return static_cast<float>((2.0f * phase / juce::MathConstants<float>::twoPi) - 1.0f);
+        case 4: // Random sample & hold
+            return lastRandomValue;
+        default:
+            return 1.0f;
+    }
+}
+
 std::vector<float> LFOdsp::getLFOBuffer()
 {
     int localWriteIndex = writeIndex.load(std::memory_order_relaxed);
@@ -25,6 +25,10 @@ public:
     void syncPhaseWith(const LFOdsp& other);
     
     float processModulation();
+    
+    /** Moves the LFO on by a whole block without rendering it sample by sample. The phase ends up
+        where processModulation() would leave it; the display buffer is filled at a coarser step. */
+    void advance(int numSamples);
     float getCurrentModulation() const;
 
     bool getSyncMode() const { return syncMode; }
@@ -48,6 +52,9 @@ private:
     double phaseIncrement = 0.0;
     
     void updatePhaseIncrement();
+    float getWaveformValue() const;
+    
+    static constexpr int advanceDisplayStep = 32;
     
     static constexpr int bufferSize = 8192;
     std::vector<float> lfoBuffer;
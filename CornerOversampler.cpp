@@ -0,0 +1,101 @@
+#include "CornerOversampler.h"
+
+namespace JackDistortion {
+
+void CornerOversampler::prepare(double sampleRate, int numChannels, int maxBlockSize)
+{
+    stages.clear();
+    for (int stageFactorLog2 = 1; stageFactorLog2 <= maxFactorLog2; ++stageFactorLog2)
+    {
+        auto stage = std::make_unique<juce::dsp::Oversampling<float>>(static_cast<size_t>(numChannels),
+                                                                      static_cast<size_t>(stageFactorLog2),
+                                                                      juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple,
+                                                                      false, true);
+        stage->initProcessing(static_cast<size_t>(maxBlockSize));
+        stages.push_back(std::move(stage));
+    }
+
+    preparedBlockSize = static_cast<size_t>(maxBlockSize);
+    alignedLatency = getStageLatency(maxFactorLog2);
+
+    for (auto& delay : alignmentDelays)
+    {
+        delay.setMaximumDelayInSamples(juce::jmax(1, alignedLatency));
+        delay.prepare({ sampleRate, static_cast<juce::uint32>(maxBlockSize), static_cast<juce::uint32>(numChannels) });
+    }
+    alignmentDelays[static_cast<size_t>(activeDelay)].setDelay(static_cast<float>(alignedLatency - getStageLatency(factorLog2)));
+
+    fadeBuffer.setSize(numChannels, maxBlockSize, false, false, true);
+    fadeRemaining = 0;
+}
+
+void CornerOversampler::reset()
+{
+    for (auto& stage : stages)
+        stage->reset();
+
+    for (auto& delay : alignmentDelays)
+        delay.reset();
+
+    fadeRemaining = 0;
+}
+
+void CornerOversampler::setFactorLog2(int newFactorLog2, bool crossfade)
+{
+    newFactorLog2 = juce::jlimit(0, maxFactorLog2, newFactorLog2);
+    if (newFactorLog2 == factorLog2 || fadeRemaining > 0)
+        return;
+
+    const int previousFactorLog2 = factorLog2;
+    factorLog2 = newFactorLog2;
+    if (stages.empty())
+        return;
+
+    // The old rate keeps its stage and delay line for the fade; the new rate starts from a
+    // cleared stage and the other delay line.
+    if (crossfade)
+    {
+        fadeFromFactorLog2 = previousFactorLog2;
+        fadeRemaining = crossfadeSamples;
+        activeDelay = 1 - activeDelay;
+    }
+
+    // The new stage and the delay both hold history from before the switch.
+    if (factorLog2 > 0)
+        stages[static_cast<size_t>(factorLog2 - 1)]->reset();
+
+    auto& delay = alignmentDelays[static_cast<size_t>(activeDelay)];
+    delay.reset();
+    delay.setDelay(static_cast<float>(alignedLatency - getStageLatency(factorLog2)));
+}
+
+void CornerOversampler::applyCrossfade(juce::dsp::AudioBlock<float> block, juce::dsp::AudioBlock<float> oldRate)
+{
+    const int numSamples = static_cast<int>(block.getNumSamples());
+    const int fadeDone = crossfadeSamples - fadeRemaining;
+
+    // Both rates carry the same signal, so a linear fade keeps the level constant.
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+    {
+        float* data = block.getChannelPointer(channel);
+        const float* old = oldRate.getChannelPointer(channel);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float fadeIn = juce::jmin(1.0f, static_cast<float>(fadeDone + i + 1) / static_cast<float>(crossfadeSamples));
+            data[i] = old[i] + (data[i] - old[i]) * fadeIn;
+        }
+    }
+
+    fadeRemaining = juce::jmax(0, fadeRemaining - numSamples);
+}
+
+int CornerOversampler::getStageLatency(int stageFactorLog2) const
+{
+    if (stageFactorLog2 == 0 || stages.empty())
+        return 0;
+
+    return juce::roundToInt(stages[static_cast<size_t>(stageFactorLog2 - 1)]->getLatencyInSamples());
+}
+
+} // namespace JackDistortion
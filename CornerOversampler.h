@@ -0,0 +1,102 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <juce_dsp/juce_dsp.h>
+
+namespace JackDistortion {
+
+//------------------------------------------------------------------------------------------------------------//
+// Runs one XY corner at its own oversampling factor. A stage for every factor is built in prepare(),
+// so switching the corner's algorithm never allocates. Each factor's filter latency is padded with a
+// delay up to the latency of the highest factor, so every corner, and the dry path delayed by
+// getLatencySamples(), lines up before the blend. Linear-phase FIR stages keep the group delay
+// constant across the band.
+class CornerOversampler
+{
+public:
+    static constexpr int maxFactorLog2 = 2;
+    static constexpr int crossfadeSamples = 512; // base-rate samples
+
+    void prepare(double sampleRate, int numChannels, int maxBlockSize);
+    void reset();
+
+    /** Switches to 2^factorLog2 times the base rate. Does nothing if already there. With crossfade,
+        the old rate keeps running next to the new one for crossfadeSamples and the output fades
+        across, so the new stage's empty filter history is never heard; changes requested while a
+        fade runs are ignored, so the caller should keep requesting the factor it wants. */
+    void setFactorLog2(int newFactorLog2, bool crossfade = false);
+    int getFactorLog2() const noexcept { return factorLog2; }
+    bool isCrossfading() const noexcept { return fadeRemaining > 0; }
+
+    /** Latency of every corner after alignment, in base-rate samples. */
+    int getLatencySamples() const noexcept { return alignedLatency; }
+
+    /** Upsamples the block, hands the oversampled block to processAtRate, then downsamples and
+        aligns the result in place. Blocks longer than the prepared size are split. During a
+        crossfade processAtRate is called once per rate, so curves with memory see the block twice. */
+    template <typename ProcessFn>
+    void process(juce::dsp::AudioBlock<float> block, ProcessFn&& processAtRate)
+    {
+        jassert(preparedBlockSize > 0);   // process before prepare
+        if (preparedBlockSize == 0)
+            return;
+
+        const auto numSamples = block.getNumSamples();
+        for (size_t start = 0; start < numSamples; start += preparedBlockSize)
+        {
+            auto subBlock = block.getSubBlock(start, juce::jmin(preparedBlockSize, numSamples - start));
+
+            if (fadeRemaining > 0)
+            {
+                auto fadeBlock = juce::dsp::AudioBlock<float>(fadeBuffer).getSubsetChannelBlock(0, subBlock.getNumChannels())
+                                                                         .getSubBlock(0, subBlock.getNumSamples());
+                fadeBlock.copyFrom(subBlock);
+                processPath(fadeBlock, fadeFromFactorLog2, alignmentDelays[static_cast<size_t>(1 - activeDelay)], processAtRate);
+                processPath(subBlock, factorLog2, alignmentDelays[static_cast<size_t>(activeDelay)], processAtRate);
+                applyCrossfade(subBlock, fadeBlock);
+            }
+            else
+            {
+                processPath(subBlock, factorLog2, alignmentDelays[static_cast<size_t>(activeDelay)], processAtRate);
+            }
+        }
+    }
+
+private:
+    using AlignmentDelay = juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::None>;
+
+    template <typename ProcessFn>
+    void processPath(juce::dsp::AudioBlock<float> block, int pathFactorLog2, AlignmentDelay& delay, ProcessFn& processAtRate)
+    {
+        if (pathFactorLog2 == 0)
+        {
+            processAtRate(block);
+        }
+        else
+        {
+            auto& stage = *stages[static_cast<size_t>(pathFactorLog2 - 1)];
+            processAtRate(stage.processSamplesUp(block));
+            stage.processSamplesDown(block);
+        }
+
+        if (delay.getDelay() > 0.0f)
+            delay.process(juce::dsp::ProcessContextReplacing<float>(block));
+    }
+
+    /** Fades the block from the old rate's output to the new one's, in place. */
+    void applyCrossfade(juce::dsp::AudioBlock<float> block, juce::dsp::AudioBlock<float> oldRate);
+
+    int getStageLatency(int stageFactorLog2) const;
+
+    std::vector<std::unique_ptr<juce::dsp::Oversampling<float>>> stages; // 2x, 4x, ...
+    std::array<AlignmentDelay, 2> alignmentDelays;                       // current rate, fading rate
+    juce::AudioBuffer<float> fadeBuffer;
+    size_t preparedBlockSize = 0;
+    int factorLog2 = 0;
+    int fadeFromFactorLog2 = 0;
+    int fadeRemaining = 0;
+    int activeDelay = 0;
+    int alignedLatency = 0;
+};
+
+} // namespace JackDistortion
@@ -0,0 +1,344 @@
+#include "DistortionAccuracy.h"
+#include "PluginProcessor.h"
+
+namespace JackDistortion::Accuracy
+{
+    namespace
+    {
+        constexpr float stimulusFrequency = 220.0f; // matches Benchmark::fillStimulus
+        constexpr int numHarmonics = 9;
+
+        double goertzelPower(const float* data, int numSamples, double frequency, double sampleRate)
+        {
+            const double coeff = 2.0 * std::cos(juce::MathConstants<double>::twoPi * frequency / sampleRate);
+            double s1 = 0.0, s2 = 0.0;
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const double s0 = data[i] + coeff * s1 - s2;
+                s2 = s1;
+                s1 = s0;
+            }
+            return s1 * s1 + s2 * s2 - coeff * s1 * s2;
+        }
+
+        double thdDecibels(const float* data, int numSamples, double fundamental, double sampleRate)
+        {
+            const double fundamentalPower = goertzelPower(data, numSamples, fundamental, sampleRate);
+            double harmonicPower = 0.0;
+            for (int h = 2; h <= numHarmonics + 1 && h * fundamental < sampleRate * 0.5; ++h)
+                harmonicPower += goertzelPower(data, numSamples, h * fundamental, sampleRate);
+
+            return 10.0 * std::log10((harmonicPower + 1.0e-20) / (fundamentalPower + 1.0e-20));
+        }
+
+        void renderAlgorithm(int algorithm, Benchmark::Stimulus stimulus, const Options& options,
+                             const Benchmark::KernelVariant& variant, juce::AudioBuffer<float>& output)
+        {
+            output.setSize(1, options.lengthInSamples);
+            Benchmark::fillStimulus(stimulus, output, options.sampleRate);
+
+            auto distortion = makeDistortion(algorithm);
+            std::visit([&options](auto& d) { d.setParameters(options.drive, 0.0f); }, distortion);
+            auto kernel = variant.prepare(distortion, options.drive);
+
+            // Rendered block by block, as the processor would, so stateful algorithms see block edges.
+            juce::AudioBuffer<float> block(1, options.blockSize);
+            for (int start = 0; start < options.lengthInSamples; start += options.blockSize)
+            {
+                const int num = juce::jmin(options.blockSize, options.lengthInSamples - start);
+                block.setSize(1, num, false, false, true);
+                block.copyFrom(0, 0, output, 0, start, num);
+                kernel(block);
+                output.copyFrom(0, start, block, 0, 0, num);
+            }
+        }
+
+        struct Scenario
+        {
+            juce::String name;
+            std::vector<std::pair<juce::String, float>> parameters;
+        };
+
+        // Pinned for every scenario, so a render never depends on how busy the machine is: the
+        // render tier at HQ and no adaptive stepping down.
+        const std::vector<std::pair<juce::String, float>> pinnedParameters { { "RenderQuality", 2.0f },
+                                                                             { "AdaptiveQuality", 0.0f } };
+
+        void renderProcessor(const Scenario& scenario, const Options& options, juce::AudioBuffer<float>& output)
+        {
+            OrbitXAudioProcessor processor;
+            processor.setNonRealtime(true);
+
+            for (const auto* parameters : { &pinnedParameters, &scenario.parameters })
+                for (auto& [id, value] : *parameters)
+                    if (auto* parameter = processor.apvts.getParameter(id))
+                        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+
+            const int numChannels = processor.getTotalNumInputChannels();
+            processor.setRateAndBufferSizeDetails(options.sampleRate, options.blockSize);
+            processor.prepareToPlay(options.sampleRate, options.blockSize);
+
+            output.setSize(numChannels, options.lengthInSamples);
+            Benchmark::fillStimulus(Benchmark::Stimulus::fullScaleSine, output, options.sampleRate);
+            output.applyGain(0.5f);
+
+            juce::AudioBuffer<float> block(numChannels, options.blockSize);
+            juce::MidiBuffer midi;
+            for (int start = 0; start < options.lengthInSamples; start += options.blockSize)
+            {
+                const int num = juce::jmin(options.blockSize, options.lengthInSamples - start);
+                block.setSize(numChannels, num, false, false, true);
+                for (int ch = 0; ch < numChannels; ++ch)
+                    block.copyFrom(ch, 0, output, ch, start, num);
+
+                processor.processBlock(block, midi);
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                    output.copyFrom(ch, start, block, ch, 0, num);
+            }
+
+            processor.releaseResources();
+        }
+
+        std::vector<Scenario> getScenarios()
+        {
+            return {
+                { "processBlock - defaults", {} },
+                { "processBlock - mixed corners",
+                  { { "Distortion_Right", 1.0f }, { "Distortion_Top", 6.0f }, { "Distortion_Left", 12.0f },
+                    { "Distortion_Bottom", 16.0f }, { "XY_X", 0.8f }, { "XY_Y", 0.3f }, { "PostXYDrive", 7.5f } } },
+                { "processBlock - half mix, no LFO",
+                  { { "OutputMix", 50.0f }, { "LFO_X_Bypass", 1.0f }, { "LFO_Y_Bypass", 1.0f },
+                    { "Distortion_Right", 8.0f }, { "Distortion_Left", 14.0f }, { "XY_X", 0.2f } } }
+            };
+        }
+
+        juce::File getReferenceFile(const juce::File& directory, const juce::String& caseName)
+        {
+            return directory.getChildFile(juce::File::createLegalFileName(caseName) + ".wav");
+        }
+
+        bool writeWav(const juce::File& file, const juce::AudioBuffer<float>& buffer, double sampleRate)
+        {
+            file.deleteFile();
+            std::unique_ptr<juce::OutputStream> stream(file.createOutputStream());
+            if (stream == nullptr)
+                return false;
+
+            juce::WavAudioFormat wav;
+            std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), sampleRate,
+                                                                                 static_cast<unsigned int>(buffer.getNumChannels()),
+                                                                                 32, {}, 0));
+            if (writer == nullptr)
+                return false;
+
+            stream.release(); // now owned by the writer
+            return writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
+        }
+
+        bool readWav(const juce::File& file, juce::AudioBuffer<float>& buffer)
+        {
+            if (! file.existsAsFile())
+                return false;
+
+            juce::WavAudioFormat wav;
+            std::unique_ptr<juce::AudioFormatReader> reader(wav.createReaderFor(file.createInputStream().release(), true));
+            if (reader == nullptr)
+                return false;
+
+            buffer.setSize(static_cast<int>(reader->numChannels), static_cast<int>(reader->lengthInSamples));
+            return reader->read(&buffer, 0, buffer.getNumSamples(), 0, true, true);
+        }
+    }
+
+    Metrics compare(const juce::AudioBuffer<float>& reference, const juce::AudioBuffer<float>& candidate,
+                    double sampleRate, float fundamental)
+    {
+        Metrics metrics;
+        if (reference.getNumChannels() != candidate.getNumChannels()
+            || reference.getNumSamples() != candidate.getNumSamples())
+        {
+            metrics.maxAbsError = std::numeric_limits<float>::infinity();
+            metrics.snrDb = -std::numeric_limits<double>::infinity();
+            metrics.thdDeltaDb = std::numeric_limits<double>::infinity();
+            return metrics;
+        }
+
+        double signalEnergy = 0.0, errorEnergy = 0.0;
+        for (int ch = 0; ch < reference.getNumChannels(); ++ch)
+        {
+            const float* ref = reference.getReadPointer(ch);
+            const float* cand = candidate.getReadPointer(ch);
+            for (int i = 0; i < reference.getNumSamples(); ++i)
+            {
+                const float error = cand[i] - ref[i];
+                metrics.maxAbsError = juce::jmax(metrics.maxAbsError, std::abs(error));
+                signalEnergy += static_cast<double>(ref[i]) * ref[i];
+                errorEnergy += static_cast<double>(error) * error;
+            }
+
+            if (fundamental > 0.0f)
+            {
+                const double delta = std::abs(thdDecibels(cand, candidate.getNumSamples(), fundamental, sampleRate)
+                                              - thdDecibels(ref, reference.getNumSamples(), fundamental, sampleRate));
+                metrics.thdDeltaDb = juce::jmax(metrics.thdDeltaDb, delta);
+            }
+        }
+
+        if (errorEnergy <= 0.0)
+            metrics.snrDb = std::numeric_limits<double>::infinity();
+        else if (signalEnergy <= 0.0)
+            metrics.snrDb = -std::numeric_limits<double>::infinity();
+        else
+            metrics.snrDb = 10.0 * std::log10(signalEnergy / errorEnergy);
+
+        return metrics;
+    }
+
+    bool passes(const Metrics& metrics, const Tolerances& tolerances)
+    {
+        return metrics.maxAbsError <= tolerances.maxAbsError
+            && (metrics.snrDb >= tolerances.minSnrDb || metrics.maxAbsError == 0.0f)
+            && metrics.thdDeltaDb <= tolerances.maxThdDeltaDb;
+    }
+
+    std::vector<Case> getCases(const Options& options)
+    {
+        std::vector<Case> cases;
+        const auto& reference = Benchmark::getKernelVariants().front(); // analytic processSample
+        const auto& names = getAlgorithmNames();
+
+        for (int algorithm = 0; algorithm < numAlgorithms; ++algorithm)
+        {
+            for (auto stimulus : Benchmark::getAllStimuli())
+            {
+                const bool isSine = stimulus == Benchmark::Stimulus::lowLevel
+                                 || stimulus == Benchmark::Stimulus::fullScaleSine;
+
+                cases.push_back({ names[algorithm] + " - " + Benchmark::getStimulusName(stimulus),
+                                  isSine ? stimulusFrequency : 0.0f,
+                                  [algorithm, stimulus, options, &reference](juce::AudioBuffer<float>& output)
+                                  { renderAlgorithm(algorithm, stimulus, options, reference, output); } });
+            }
+        }
+
+        for (auto& scenario : getScenarios())
+        {
+            cases.push_back({ scenario.name, stimulusFrequency,
+                              [scenario, options](juce::AudioBuffer<float>& output)
+                              { renderProcessor(scenario, options, output); } });
+        }
+
+        return cases;
+    }
+
+    bool writeReferences(const juce::File& directory, const Options& options)
+    {
+        auto result = directory.createDirectory();
+        if (result.failed())
+        {
+            DBG("Could not create reference directory: " + result.getErrorMessage());
+            return false;
+        }
+
+        bool ok = true;
+        juce::AudioBuffer<float> rendered;
+        for (auto& c : getCases(options))
+        {
+            c.render(rendered);
+            if (! writeWav(getReferenceFile(directory, c.name), rendered, options.sampleRate))
+            {
+                DBG("Could not write reference for " + c.name);
+                ok = false;
+            }
+        }
+        return ok;
+    }
+
+    std::vector<CaseResult> checkAgainstReferences(const juce::File& directory, const Options& options,
+                                                   const Tolerances& tolerances)
+    {
+        std::vector<CaseResult> results;
+        juce::AudioBuffer<float> rendered, reference;
+
+        for (auto& c : getCases(options))
+        {
+            CaseResult result;
+            result.name = c.name;
+            result.referenceFound = readWav(getReferenceFile(directory, c.name), reference);
+
+            if (result.referenceFound)
+            {
+                c.render(rendered);
+                result.metrics = compare(reference, rendered, options.sampleRate, c.fundamental);
+                result.passed = passes(result.metrics, tolerances);
+            }
+
+            results.push_back(result);
+        }
+        return results;
+    }
+
+    juce::String formatCheckReport(const std::vector<CaseResult>& results)
+    {
+        juce::String report;
+        int failures = 0;
+
+        for (auto& r : results)
+        {
+            if (! r.referenceFound)
+            {
+                report << "MISSING  " << r.name << juce::newLine;
+                ++failures;
+                continue;
+            }
+
+            report << (r.passed ? "ok       " : "FAIL     ") << r.name
+                   << "  max err " << juce::String(r.metrics.maxAbsError, 8)
+                   << "  SNR " << (std::isinf(r.metrics.snrDb) ? juce::String("inf") : juce::String(r.metrics.snrDb, 1)) << " dB"
+                   << "  THD delta " << juce::String(r.metrics.thdDeltaDb, 3) << " dB" << juce::newLine;
+
+            if (! r.passed)
+                ++failures;
+        }
+
+        report << juce::newLine << juce::String(static_cast<int>(results.size()) - failures) << " passed, "
+               << juce::String(failures) << " failed" << juce::newLine;
+        return report;
+    }
+
+    juce::String formatTierReport(const Options& options)
+    {
+        const auto& variants = Benchmark::getKernelVariants();
+        const auto& names = getAlgorithmNames();
+
+        Benchmark::Options benchOptions;
+        benchOptions.sampleRate = options.sampleRate;
+        benchOptions.blockSize = options.blockSize;
+        benchOptions.drive = options.drive;
+        benchOptions.numBlocks = 200;
+
+        juce::String report;
+        report << "Algorithm / tier                      max err       SNR (dB)   THD delta   ns/sample" << juce::newLine;
+
+        juce::AudioBuffer<float> reference, candidate;
+        for (int algorithm = 0; algorithm < numAlgorithms; ++algorithm)
+        {
+            renderAlgorithm(algorithm, Benchmark::Stimulus::fullScaleSine, options, variants.front(), reference);
+
+            for (auto& variant : variants)
+            {
+                renderAlgorithm(algorithm, Benchmark::Stimulus::fullScaleSine, options, variant, candidate);
+                const auto metrics = compare(reference, candidate, options.sampleRate, stimulusFrequency);
+                const auto timing = Benchmark::measure(algorithm, variant, Benchmark::Stimulus::fullScaleSine, benchOptions);
+
+                report << (names[algorithm] + " / " + variant.name).paddedRight(' ', 38)
+                       << juce::String(metrics.maxAbsError, 8).paddedRight(' ', 14)
+                       << (std::isinf(metrics.snrDb) ? juce::String("inf") : juce::String(metrics.snrDb, 1)).paddedRight(' ', 11)
+                       << juce::String(metrics.thdDeltaDb, 3).paddedRight(' ', 12)
+                       << juce::String(timing.nanosecondsPerSample, 2) << juce::newLine;
+            }
+        }
+        return report;
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "DistortionBenchmark.h"
+
+//==============================================================================
+// Golden-output and approximation-accuracy checks.
+//
+// Fixed stimuli are rendered through every algorithm and through the full processBlock, then
+// compared against stored reference WAVs (32-bit float) with tolerance-based checks. The tier
+// report compares every kernel variant registered with the benchmark against the analytic
+// processSample output, so faster approximations show their error next to their speed.
+//
+// The references live in Tools/OrbitXRender/Golden, written on the scalar path (an x86-64 SSE2
+// build with the generic kernels). The tolerances leave room for FMA contraction and the AVX2
+// and AVX-512 paths, which stay within 2e-5 and 125 dB SNR of them. The processBlock cases also
+// run through JUCE's oversampling filters; their references are written into the same directory
+// with OrbitXRender --write-golden from such a build.
+// A case without a reference fails the check rather than passing.
+namespace JackDistortion::Accuracy
+{
+    struct Options
+    {
+        double sampleRate = 48000.0;
+        int lengthInSamples = 4800; // 22 whole cycles of the 220 Hz stimulus; keeps the references small
+        int blockSize = 512;
+        float drive = 5.0f; // PostXYDrive default
+    };
+
+    struct Tolerances
+    {
+        float maxAbsError = 1.0e-4f;
+        double minSnrDb = 100.0;
+        double maxThdDeltaDb = 0.1;
+    };
+
+    struct Metrics
+    {
+        float maxAbsError = 0.0f;
+        double snrDb = 0.0;      // reference energy over error energy; infinite when identical
+        double thdDeltaDb = 0.0; // only measured for sine stimuli
+    };
+
+    /** Compares two renders. THD is measured when a fundamental frequency is given. */
+    Metrics compare(const juce::AudioBuffer<float>& reference, const juce::AudioBuffer<float>& candidate,
+                    double sampleRate, float fundamental);
+
+    bool passes(const Metrics& metrics, const Tolerances& tolerances);
+
+    /** A named render with a fixed stimulus; fundamental is 0 when THD does not apply. */
+    struct Case
+    {
+        juce::String name;
+        float fundamental = 0.0f;
+        std::function<void(juce::AudioBuffer<float>&)> render;
+    };
+
+    /** Every algorithm with every benchmark stimulus, plus a few full processBlock scenarios. */
+    std::vector<Case> getCases(const Options& options);
+
+    /** Renders every case and stores it as <directory>/<case name>.wav. */
+    bool writeReferences(const juce::File& directory, const Options& options);
+
+    struct CaseResult
+    {
+        juce::String name;
+        Metrics metrics;
+        bool referenceFound = false;
+        bool passed = false;
+    };
+
+    std::vector<CaseResult> checkAgainstReferences(const juce::File& directory, const Options& options,
+                                                   const Tolerances& tolerances);
+
+    juce::String formatCheckReport(const std::vector<CaseResult>& results);
+
+    /** Error and cost of each kernel variant relative to the analytic processSample kernel. */
+    juce::String formatTierReport(const Options& options);
+}
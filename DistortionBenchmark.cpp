@@ -0,0 +1,256 @@
+#include "DistortionBenchmark.h"
+#include "SharedTables.h"
+
+namespace JackDistortion::Benchmark
+{
+    namespace
+    {
+        // Stops the optimiser from discarding the rendered output.
+        volatile float benchmarkSink = 0.0f;
+
+        void consume(const juce::AudioBuffer<float>& buffer)
+        {
+            float sum = 0.0f;
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                sum += buffer.getSample(ch, buffer.getNumSamples() - 1);
+            benchmarkSink = benchmarkSink + sum;
+        }
+
+        juce::String padded(const juce::String& text, int width)
+        {
+            return text + juce::String::repeatedString(" ", juce::jmax(1, width - text.length()));
+        }
+    }
+
+    juce::String getStimulusName(Stimulus stimulus)
+    {
+        switch (stimulus)
+        {
+            case Stimulus::silence:       return "Silence";
+            case Stimulus::lowLevel:      return "-40 dBFS sine";
+            case Stimulus::fullScaleSine: return "0 dBFS sine";
+            case Stimulus::hotNoise:      return "+6 dBFS noise";
+        }
+        return {};
+    }
+
+    const std::vector<Stimulus>& getAllStimuli()
+    {
+        static const std::vector<Stimulus> stimuli { Stimulus::silence, Stimulus::lowLevel,
+                                                     Stimulus::fullScaleSine, Stimulus::hotNoise };
+        return stimuli;
+    }
+
+    void fillStimulus(Stimulus stimulus, juce::AudioBuffer<float>& buffer, double sampleRate)
+    {
+        const float frequency = 220.0f;
+        const float phaseStep = juce::MathConstants<float>::twoPi * frequency / static_cast<float>(sampleRate);
+        juce::Random random(0x0b17);
+
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            float* data = buffer.getWritePointer(ch);
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+            {
+                switch (stimulus)
+                {
+                    case Stimulus::silence:       data[i] = 0.0f; break;
+                    case Stimulus::lowLevel:      data[i] = 0.01f * std::sin(phaseStep * static_cast<float>(i)); break;
+                    case Stimulus::fullScaleSine: data[i] = std::sin(phaseStep * static_cast<float>(i)); break;
+                    case Stimulus::hotNoise:      data[i] = 2.0f * (random.nextFloat() * 2.0f - 1.0f); break;
+                }
+            }
+        }
+    }
+
+    const std::vector<KernelVariant>& getKernelVariants()
+    {
+        static const std::vector<KernelVariant> variants
+        {
+            { "processSample", [](AnyDistortion& algorithm, float) -> BlockKernel
+                {
+                    return [&algorithm](juce::AudioBuffer<float>& buffer)
+                    {
+                        std::visit([&buffer](auto& distortion)
+                        {
+                            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                            {
+                                float* data = buffer.getWritePointer(ch);
+                                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                                    data[i] = distortion.processSample(data[i]);
+                            }
+                        }, algorithm);
+                    };
+                } },
+            { "processBuffer", [](AnyDistortion& algorithm, float) -> BlockKernel
+                {
+                    auto& base = std::visit([](auto& distortion) -> DistortionBase& { return distortion; }, algorithm);
+                    return [&base](juce::AudioBuffer<float>& buffer)
+                    {
+                        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                            base.processBuffer(buffer, ch);
+                    };
+                } },
+            { "curve LUT", [](AnyDistortion& algorithm, float drive) -> BlockKernel
+                {
+                    // The table comes from the process-wide cache, as an instance would get it, and is
+                    // waited for here so its build is not timed. Stateful curves cannot be tabulated
+                    // and run analytically instead.
+                    const int index = static_cast<int>(algorithm.index());
+                    juce::SharedResourcePointer<SharedTableCache> cache;
+                    auto table = canTabulateCurve(index) ? cache->requestCurve(index, drive) : nullptr;
+                    while (table != nullptr && ! table->isReady())
+                        juce::Thread::sleep(1);
+
+                    return [&algorithm, table](juce::AudioBuffer<float>& buffer)
+                    {
+                        std::visit([&buffer, &table](auto& distortion)
+                        {
+                            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                            {
+                                float* data = buffer.getWritePointer(ch);
+                                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                                {
+                                    float shaped;
+                                    if (table != nullptr && lookupCurve(table->data(), table->size(), data[i], shaped))
+                                        data[i] = shaped;
+                                    else
+                                        data[i] = distortion.processSample(data[i]);
+                                }
+                            }
+                        }, algorithm);
+                    };
+                } },
+            { "SIMD samples", [](AnyDistortion& algorithm, float) -> BlockKernel
+                {
+                    // Curves without a vector kernel fall back to the scalar loop, as in the processor.
+                    return [&algorithm](juce::AudioBuffer<float>& buffer)
+                    {
+                        std::visit([&buffer](auto& distortion)
+                        {
+                            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                            {
+                                float* data = buffer.getWritePointer(ch);
+                                if constexpr (HasVectorKernel<std::decay_t<decltype(distortion)>>::value)
+                                {
+                                    distortion.processSamples(data, buffer.getNumSamples());
+                                }
+                                else
+                                {
+                                    for (int i = 0; i < buffer.getNumSamples(); ++i)
+                                        data[i] = distortion.processSample(data[i]);
+                                }
+                            }
+                        }, algorithm);
+                    };
+                } }
+        };
+        return variants;
+    }
+
+    Result measure(int algorithm, const KernelVariant& variant, Stimulus stimulus, const Options& options)
+    {
+        juce::AudioBuffer<float> source(1, options.blockSize);
+        juce::AudioBuffer<float> work(1, options.blockSize);
+        fillStimulus(stimulus, source, options.sampleRate);
+
+        auto distortion = makeDistortion(algorithm);
+        std::visit([&options](auto& d) { d.setParameters(options.drive, 0.0f); }, distortion);
+        auto kernel = variant.prepare(distortion, options.drive);
+
+        auto runBlock = [&]
+        {
+            work.copyFrom(0, 0, source, 0, 0, options.blockSize);
+            kernel(work);
+            consume(work);
+        };
+
+        for (int i = 0; i < options.warmupBlocks; ++i)
+            runBlock();
+
+        // The copy into the work buffer is timed on its own and subtracted.
+        const auto copyStart = juce::Time::getHighResolutionTicks();
+        for (int i = 0; i < options.numBlocks; ++i)
+        {
+            work.copyFrom(0, 0, source, 0, 0, options.blockSize);
+            consume(work);
+        }
+        const auto copyTicks = juce::Time::getHighResolutionTicks() - copyStart;
+
+        const auto start = juce::Time::getHighResolutionTicks();
+        for (int i = 0; i < options.numBlocks; ++i)
+            runBlock();
+        const auto ticks = juce::Time::getHighResolutionTicks() - start;
+
+        const double seconds = juce::Time::highResolutionTicksToSeconds(juce::jmax<juce::int64>(0, ticks - copyTicks));
+        const double totalSamples = static_cast<double>(options.numBlocks) * options.blockSize;
+
+        Result result;
+        result.algorithm = algorithm;
+        result.variant = variant.name;
+        result.stimulus = stimulus;
+        result.nanosecondsPerSample = seconds * 1.0e9 / totalSamples;
+        return result;
+    }
+
+    std::vector<Result> runAll(const Options& options)
+    {
+        std::vector<Result> results;
+        for (int algorithm = 0; algorithm < numAlgorithms; ++algorithm)
+            for (auto& variant : getKernelVariants())
+                for (auto stimulus : getAllStimuli())
+                    results.push_back(measure(algorithm, variant, stimulus, options));
+        return results;
+    }
+
+    juce::String formatReport(const std::vector<Result>& results)
+    {
+        const auto& names = getAlgorithmNames();
+        const auto& stimuli = getAllStimuli();
+
+        juce::String report;
+        report << "Kernel path: " << Kernels::getInstructionSetName(Kernels::getInstructionSet())
+               << " (detected " << Kernels::getInstructionSetName(Kernels::detectInstructionSet()) << ")" << juce::newLine
+               << juce::newLine;
+        report << padded("Algorithm", 22) << padded("Variant", 16);
+        for (auto stimulus : stimuli)
+            report << padded(getStimulusName(stimulus), 16);
+        report << juce::newLine;
+
+        // Results are grouped per algorithm / variant, one column per stimulus (ns per sample).
+        std::map<std::pair<int, juce::String>, std::map<int, double>> table;
+        std::array<double, numAlgorithms> worstCase {};
+        for (auto& r : results)
+        {
+            table[{ r.algorithm, r.variant }][static_cast<int>(r.stimulus)] = r.nanosecondsPerSample;
+            worstCase[static_cast<size_t>(r.algorithm)] = juce::jmax(worstCase[static_cast<size_t>(r.algorithm)],
+                                                                     r.nanosecondsPerSample);
+        }
+
+        for (auto& [key, row] : table)
+        {
+            report << padded(names[key.first], 22) << padded(key.second, 16);
+            for (auto stimulus : stimuli)
+            {
+                auto found = row.find(static_cast<int>(stimulus));
+                report << padded(found != row.end() ? juce::String(found->second, 2) : juce::String("-"), 16);
+            }
+            report << juce::newLine;
+        }
+
+        std::vector<int> ranking;
+        for (auto& [key, row] : table)
+            if (ranking.empty() || ranking.back() != key.first)
+                ranking.push_back(key.first);
+
+        std::sort(ranking.begin(), ranking.end(), [&worstCase](int a, int b)
+                  { return worstCase[static_cast<size_t>(a)] > worstCase[static_cast<size_t>(b)]; });
+
+        report << juce::newLine << "Worst-case cost (ns/sample), most expensive first:" << juce::newLine;
+        for (auto algorithm : ranking)
+            report << "  " << padded(names[algorithm], 22)
+                   << juce::String(worstCase[static_cast<size_t>(algorithm)], 2) << juce::newLine;
+
+        return report;
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "distortion.h"
+
+//==============================================================================
+// Microbenchmarks for the individual JackDistortion kernels.
+//
+// Every algorithm in the registry is run over a set of stimuli through each kernel variant
+// (the scalar processSample loop, the virtual processBuffer call, the curve lookup table, and
+// any faster variant that registers itself in getKernelVariants()). Several curves have
+// input-dependent cost, so the stimuli cover silence, low-level signal, a full-scale sine and
+// hot noise.
+namespace JackDistortion::Benchmark
+{
+    enum class Stimulus
+    {
+        silence,
+        lowLevel,       // -40 dBFS sine
+        fullScaleSine,  // 0 dBFS sine
+        hotNoise        // +6 dBFS white noise
+    };
+
+    juce::String getStimulusName(Stimulus stimulus);
+    const std::vector<Stimulus>& getAllStimuli();
+
+    /** Fills every channel of the buffer with the given stimulus, deterministically. */
+    void fillStimulus(Stimulus stimulus, juce::AudioBuffer<float>& buffer, double sampleRate);
+
+    /** Runs one configured algorithm over a block in place. */
+    using BlockKernel = std::function<void(juce::AudioBuffer<float>&)>;
+
+    /** One way of running an algorithm over a block, e.g. scalar, block or table processing.
+        prepare() binds it to an algorithm already set to the given drive; any tables are built
+        there, outside the timed loop. */
+    struct KernelVariant
+    {
+        juce::String name;
+        std::function<BlockKernel(AnyDistortion&, float drive)> prepare;
+    };
+
+    const std::vector<KernelVariant>& getKernelVariants();
+
+    struct Options
+    {
+        double sampleRate = 48000.0;
+        int blockSize = 512;
+        int numBlocks = 1000;
+        int warmupBlocks = 20;
+        float drive = 5.0f; // PostXYDrive default
+    };
+
+    struct Result
+    {
+        int algorithm = 0;
+        juce::String variant;
+        Stimulus stimulus = Stimulus::silence;
+        double nanosecondsPerSample = 0.0;
+    };
+
+    /** Times one algorithm / variant / stimulus combination. */
+    Result measure(int algorithm, const KernelVariant& variant, Stimulus stimulus, const Options& options);
+
+    /** Times every registered algorithm with every variant and stimulus. */
+    std::vector<Result> runAll(const Options& options);
+
+    /** Table of all results, followed by the algorithms ranked by their worst-case cost. */
+    juce::String formatReport(const std::vector<Result>& results);
+}
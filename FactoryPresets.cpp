@@ -0,0 +1,48 @@
+#include "FactoryPresets.h"
+#include "PresetManager.h"
+
+namespace Service
+{
+    namespace
+    {
+        std::vector<FactoryPreset> buildFactoryPresets()
+        {
+            std::vector<FactoryPreset> presets;
+
+            for (int i = 0; i < BinaryData::namedResourceListSize; ++i)
+            {
+                const auto* resourceName = BinaryData::namedResourceList[i];
+                const juce::String fileName { BinaryData::getNamedResourceOriginalFilename(resourceName) };
+                if (! fileName.endsWithIgnoreCase("." + PresetManager::extension))
+                    continue;
+
+                int size = 0;
+                const auto* data = BinaryData::getNamedResource(resourceName, size);
+                if (data == nullptr || size <= 0)
+                    continue;
+
+                presets.push_back({ juce::File::createFileWithoutCheckingPath(fileName).getFileNameWithoutExtension(),
+                                    data, static_cast<size_t>(size) });
+            }
+
+            std::sort(presets.begin(), presets.end(),
+                      [](const FactoryPreset& a, const FactoryPreset& b) { return a.name.compareNatural(b.name) < 0; });
+            return presets;
+        }
+    }
+
+    const std::vector<FactoryPreset>& getFactoryPresets()
+    {
+        static const std::vector<FactoryPreset> presets = buildFactoryPresets();
+        return presets;
+    }
+
+    const FactoryPreset* findFactoryPreset(const juce::String& presetName)
+    {
+        for (const auto& preset : getFactoryPresets())
+            if (preset.name == presetName)
+                return &preset;
+
+        return nullptr;
+    }
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace Service
+{
+    //==============================================================================
+    // The factory bank: every .preset file added to the project's binary resources, i.e. the
+    // files in Assets/FactoryPresets. They are in the StateFormat layout and are read straight
+    // from the bytes compiled into the plugin, so listing or loading one never copies it, never
+    // parses XML and never touches the disk. To add one, save it from the plugin and copy the file
+    // into that folder.
+    struct FactoryPreset
+    {
+        juce::String name;          // the file name without its extension
+        const void* data = nullptr; // the embedded bytes, valid for the life of the process
+        size_t size = 0;
+    };
+
+    /** The bank, sorted by name. Built the first time it is asked for. */
+    const std::vector<FactoryPreset>& getFactoryPresets();
+
+    /** The factory preset with this name, or nullptr. */
+    const FactoryPreset* findFactoryPreset(const juce::String& presetName);
+}
@@ -0,0 +1,159 @@
+#include "KernelDispatch.h"
+
+namespace JackDistortion::Kernels
+{
+    namespace
+    {
+        std::atomic<InstructionSet>& activeInstructionSet()
+        {
+            static std::atomic<InstructionSet> active { detectInstructionSet() };
+            return active;
+        }
+
+        template <bool rampWeights, bool rampMix>
+        inline void blendLoop(float* data, int numSamples, const BlendControls& controls)
+        {
+            const float* outputRight  = controls.corners[cornerRight];
+            const float* outputTop    = controls.corners[cornerTop];
+            const float* outputLeft   = controls.corners[cornerLeft];
+            const float* outputBottom = controls.corners[cornerBottom];
+
+            for (int sample = 0; sample < numSamples; ++sample)
+            {
+                float weightRight, weightTop, weightLeft, weightBottom;
+                if constexpr (rampWeights)
+                {
+                    weightRight  = controls.weightRamps[cornerRight][sample]  * controls.cornerGains[cornerRight];
+                    weightTop    = controls.weightRamps[cornerTop][sample]    * controls.cornerGains[cornerTop];
+                    weightLeft   = controls.weightRamps[cornerLeft][sample]   * controls.cornerGains[cornerLeft];
+                    weightBottom = controls.weightRamps[cornerBottom][sample] * controls.cornerGains[cornerBottom];
+                }
+                else
+                {
+                    weightRight  = controls.weights[cornerRight];
+                    weightTop    = controls.weights[cornerTop];
+                    weightLeft   = controls.weights[cornerLeft];
+                    weightBottom = controls.weights[cornerBottom];
+                }
+
+                float inputSample = data[sample];   // dry, delayed to the corners' latency
+
+                float blendedSample = (outputRight[sample]  * weightRight +
+                                       outputTop[sample]    * weightTop +
+                                       outputLeft[sample]   * weightLeft +
+                                       outputBottom[sample] * weightBottom);
+
+                blendedSample *= 0.25f;
+
+                float currentOutputMix;
+                if constexpr (rampMix)
+                    currentOutputMix = controls.mixRamp[sample];
+                else
+                    currentOutputMix = controls.mix;
+
+                data[sample] = (blendedSample * currentOutputMix) + (inputSample * (1.0f - currentOutputMix));
+            }
+        }
+
+        using BlendFn = void (*)(float*, int, const BlendControls&);
+
+        // One entry per combination of moving controls: [rampWeights][rampMix].
+        using BlendTable = std::array<std::array<BlendFn, 2>, 2>;
+
+        template <bool rampWeights, bool rampMix>
+        void blendGeneric(float* data, int numSamples, const BlendControls& controls)
+        {
+            blendLoop<rampWeights, rampMix>(data, numSamples, controls);
+        }
+
+       #if JACKDISTORTION_MULTI_ISA
+        template <bool rampWeights, bool rampMix>
+        JACKDISTORTION_TARGET_AVX2 void blendAvx2(float* data, int numSamples, const BlendControls& controls)
+        {
+            blendLoop<rampWeights, rampMix>(data, numSamples, controls);
+        }
+
+        template <bool rampWeights, bool rampMix>
+        JACKDISTORTION_TARGET_AVX512 void blendAvx512(float* data, int numSamples, const BlendControls& controls)
+        {
+            blendLoop<rampWeights, rampMix>(data, numSamples, controls);
+        }
+       #endif
+
+        const BlendTable& getBlendTable(InstructionSet set)
+        {
+            static const BlendTable generic { { { blendGeneric<false, false>, blendGeneric<false, true> },
+                                                { blendGeneric<true, false>,  blendGeneric<true, true> } } };
+           #if JACKDISTORTION_MULTI_ISA
+            static const BlendTable avx2    { { { blendAvx2<false, false>, blendAvx2<false, true> },
+                                                { blendAvx2<true, false>,  blendAvx2<true, true> } } };
+            static const BlendTable avx512  { { { blendAvx512<false, false>, blendAvx512<false, true> },
+                                                { blendAvx512<true, false>,  blendAvx512<true, true> } } };
+
+            switch (set)
+            {
+                case InstructionSet::avx512:  return avx512;
+                case InstructionSet::avx2:    return avx2;
+                case InstructionSet::generic: break;
+            }
+           #else
+            juce::ignoreUnused(set);
+           #endif
+
+            return generic;
+        }
+    }
+
+    //==============================================================================
+    InstructionSet detectInstructionSet()
+    {
+       #if JACKDISTORTION_MULTI_ISA
+        // SystemStats reads CPUID; AVX-512 kernels only need the foundation subset.
+        if (juce::SystemStats::hasAVX512F())
+            return InstructionSet::avx512;
+
+        if (juce::SystemStats::hasAVX2())
+            return InstructionSet::avx2;
+       #endif
+
+        return InstructionSet::generic;
+    }
+
+    InstructionSet getInstructionSet() noexcept
+    {
+        return activeInstructionSet().load(std::memory_order_relaxed);
+    }
+
+    void setInstructionSet(InstructionSet newSet)
+    {
+        const auto detected = detectInstructionSet();
+        activeInstructionSet().store(static_cast<int>(newSet) > static_cast<int>(detected) ? detected : newSet);
+    }
+
+    juce::String getInstructionSetName(InstructionSet set)
+    {
+        switch (set)
+        {
+            case InstructionSet::avx512: return "AVX-512";
+            case InstructionSet::avx2:   return "AVX2";
+            case InstructionSet::generic:
+               #if JUCE_INTEL
+                return "SSE2";
+               #elif JUCE_ARM
+                return "NEON";
+               #else
+                return "Scalar";
+               #endif
+        }
+
+        jassertfalse;
+        return {};
+    }
+
+    void blendCorners(float* data, int numSamples, const BlendControls& controls)
+    {
+        const bool rampWeights = controls.weightRamps[cornerRight] != nullptr;
+        const bool rampMix = controls.mixRamp != nullptr;
+        getBlendTable(getInstructionSet())[rampWeights ? 1 : 0][rampMix ? 1 : 0](data, numSamples, controls);
+    }
+}
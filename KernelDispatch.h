@@ -0,0 +1,140 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <juce_dsp/juce_dsp.h>
+#include <cstdint>
+#include "MorphWeights.h"
+
+// GCC and Clang can build a function for an instruction set the rest of the binary does not assume,
+// so one build runs on every x86 machine and still uses AVX2 or AVX-512 where they exist. Other
+// compilers and architectures use the SIMDRegister path only.
+#if JUCE_INTEL && (JUCE_GCC || JUCE_CLANG)
+ #define JACKDISTORTION_MULTI_ISA 1
+ #define JACKDISTORTION_TARGET_AVX2   __attribute__((target("avx2")))
+ #define JACKDISTORTION_TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+ #define JACKDISTORTION_MULTI_ISA 0
+#endif
+
+//==============================================================================
+// Runtime selection of the instruction set used by the hot kernels: the corner curves and the
+// corner blend. The CPU is queried once, the first time a kernel runs, and every kernel then
+// branches to the widest build the machine supports. The AVX2 path is built without FMA and
+// matches the generic path bit for bit. AVX-512 implies FMA, and the compiler may fuse a multiply
+// and add there, so its output can differ from the others in the last bit; force a common path
+// with setInstructionSet() where renders from different machines must be identical.
+namespace JackDistortion::Kernels
+{
+    enum class InstructionSet
+    {
+        generic, // SIMDRegister at the build's baseline (SSE2 on x86, NEON on ARM)
+        avx2,
+        avx512
+    };
+
+    /** The widest instruction set this CPU and this build can both run. */
+    InstructionSet detectInstructionSet();
+
+    /** The instruction set the kernels use. */
+    InstructionSet getInstructionSet() noexcept;
+
+    /** Forces a narrower path, e.g. to compare paths in the benchmark. Requests for a path the
+        CPU does not support are clamped to the detected one. */
+    void setInstructionSet(InstructionSet newSet);
+
+    juce::String getInstructionSetName(InstructionSet set);
+
+    //==============================================================================
+    // The four corners blended into the dry signal. A ramp pointer is only set when that control
+    // is moving in this block; otherwise the constant next to it is used.
+    struct BlendControls
+    {
+        std::array<const float*, numCorners> corners {};
+        std::array<const float*, numCorners> weightRamps {};
+        std::array<float, numCorners> weights {};      // gain-scaled, when settled
+        std::array<float, numCorners> cornerGains {};
+        const float* mixRamp = nullptr;
+        float mix = 1.0f;
+    };
+
+    /** Replaces the dry samples in data with the weighted corner blend, mixed against the dry. */
+    void blendCorners(float* data, int numSamples, const BlendControls& controls);
+
+    //==============================================================================
+   #if JUCE_USE_SIMD
+    using FloatVector = juce::dsp::SIMDRegister<float>;
+   #endif
+
+    namespace detail
+    {
+        // The shape is taken by value so its constants are known not to alias the samples.
+        template <typename ShapeFn>
+        void mapSamplesGeneric(float* data, int numSamples, ShapeFn shape)
+        {
+            int i = 0;
+
+           #if JUCE_USE_SIMD
+            constexpr int width = static_cast<int>(FloatVector::SIMDNumElements);
+            const auto misalignment = reinterpret_cast<std::uintptr_t>(data) % FloatVector::SIMDRegisterSize;
+            const int head = juce::jmin(numSamples, misalignment == 0 ? 0 : static_cast<int>((FloatVector::SIMDRegisterSize - misalignment) / sizeof(float)));
+
+            for (; i < head; ++i)
+                data[i] = shape(data[i]);
+
+            for (; i + width <= numSamples; i += width)
+                shape(FloatVector::fromRawArray(data + i)).copyToRawArray(data + i);
+           #endif
+
+            for (; i < numSamples; ++i)
+                data[i] = shape(data[i]);
+        }
+
+       #if JACKDISTORTION_MULTI_ISA
+        // Plain loops; the compiler vectorises them at the width of the function's target.
+        template <typename ShapeFn>
+        JACKDISTORTION_TARGET_AVX2 void mapSamplesAvx2(float* data, int numSamples, ShapeFn shape)
+        {
+            for (int i = 0; i < numSamples; ++i)
+                data[i] = shape(data[i]);
+        }
+
+        template <typename ShapeFn>
+        JACKDISTORTION_TARGET_AVX512 void mapSamplesAvx512(float* data, int numSamples, ShapeFn shape)
+        {
+            for (int i = 0; i < numSamples; ++i)
+                data[i] = shape(data[i]);
+        }
+       #endif
+    }
+
+    /** Applies a memoryless curve to every sample. The shape is a generic lambda that works on a
+        float and, with JUCE_USE_SIMD, on a FloatVector, using only arithmetic and the lane helpers
+        below. */
+    template <typename ShapeFn>
+    void mapSamples(float* data, int numSamples, const ShapeFn& shape)
+    {
+       #if JACKDISTORTION_MULTI_ISA
+        switch (getInstructionSet())
+        {
+            case InstructionSet::avx512: detail::mapSamplesAvx512(data, numSamples, shape); return;
+            case InstructionSet::avx2:   detail::mapSamplesAvx2(data, numSamples, shape);   return;
+            case InstructionSet::generic: break;
+        }
+       #endif
+
+        detail::mapSamplesGeneric(data, numSamples, shape);
+    }
+
+    // Lane helpers with the same meaning for a float and a FloatVector.
+    inline float laneClamp(float x, float lower, float upper) noexcept { return juce::jmin(upper, juce::jmax(lower, x)); }
+    inline float laneAbs(float x) noexcept                              { return std::abs(x); }
+
+   #if JUCE_USE_SIMD
+    inline FloatVector laneClamp(FloatVector x, float lower, float upper) noexcept
+    {
+        return FloatVector::min(FloatVector::expand(upper), FloatVector::max(FloatVector::expand(lower), x));
+    }
+
+    inline FloatVector laneAbs(FloatVector x) noexcept { return FloatVector::abs(x); }
+   #endif
+}
@@ -0,0 +1,143 @@
+#include "LoudnessCompensation.h"
+#include "LoudnessCompensationTable.h"
+
+namespace JackDistortion::Loudness
+{
+    static_assert(std::size(Generated::compensationDb) == static_cast<size_t>(numAlgorithms)
+                  && std::size(Generated::compensationDb[0]) == static_cast<size_t>(numDriveSteps),
+                  "LoudnessCompensationTable.h is out of date; re-run OrbitXRender --calibrate");
+
+    namespace
+    {
+        float getDriveForStep(int step)
+        {
+            return minDrive + (maxDrive - minDrive) * static_cast<float>(step) / static_cast<float>(numDriveSteps - 1);
+        }
+    }
+
+    float getCompensationDb(int algorithm, float drive)
+    {
+        const auto& row = Generated::compensationDb[juce::jlimit(0, numAlgorithms - 1, algorithm)];
+        const float position = (juce::jlimit(minDrive, maxDrive, drive) - minDrive)
+                             * static_cast<float>(numDriveSteps - 1) / (maxDrive - minDrive);
+        const int index = juce::jmin(static_cast<int>(position), numDriveSteps - 2);
+        const float frac = position - static_cast<float>(index);
+        return row[index] + frac * (row[index + 1] - row[index]);
+    }
+
+    //==============================================================================
+    void fillReferenceProgramme(juce::AudioBuffer<float>& buffer, double sampleRate, float levelDb)
+    {
+        // Log-spaced partials from 60 Hz to 8 kHz with Schroeder phases, which keep the crest
+        // factor close to that of a single sine.
+        constexpr int numPartials = 12;
+        const double lowest = 60.0, highest = 8000.0;
+
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            float* data = buffer.getWritePointer(ch);
+            double sumSquares = 0.0;
+
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+            {
+                double value = 0.0;
+                for (int k = 0; k < numPartials; ++k)
+                {
+                    const double frequency = lowest * std::pow(highest / lowest, k / static_cast<double>(numPartials - 1));
+                    const double phase = -juce::MathConstants<double>::pi * k * (k - 1) / numPartials;
+                    value += std::sin(juce::MathConstants<double>::twoPi * frequency * i / sampleRate + phase);
+                }
+                data[i] = static_cast<float>(value);
+                sumSquares += value * value;
+            }
+
+            const double rms = std::sqrt(sumSquares / juce::jmax(1, buffer.getNumSamples()));
+            if (rms > 0.0)
+                buffer.applyGain(ch, 0, buffer.getNumSamples(),
+                                 static_cast<float>(juce::Decibels::decibelsToGain(static_cast<double>(levelDb)) / rms));
+        }
+    }
+
+    float measureOutputLevelDb(int algorithm, float drive, const CalibrationOptions& options)
+    {
+        juce::AudioBuffer<float> buffer(1, options.lengthInSamples);
+        fillReferenceProgramme(buffer, options.sampleRate, options.referenceLevelDb);
+
+        auto distortion = makeDistortion(algorithm);
+        float* data = buffer.getWritePointer(0);
+        std::visit([&](auto& d)
+        {
+            d.setParameters(drive, 0.0f);
+            for (int i = 0; i < options.lengthInSamples; ++i)
+                data[i] = d.processSample(data[i]);
+        }, distortion);
+
+        double sum = 0.0, sumSquares = 0.0;
+        for (int i = 0; i < options.lengthInSamples; ++i)
+        {
+            sum += data[i];
+            sumSquares += static_cast<double>(data[i]) * data[i];
+        }
+
+        const double n = static_cast<double>(juce::jmax(1, options.lengthInSamples));
+        const double mean = sum / n;
+        const double variance = juce::jmax(0.0, sumSquares / n - mean * mean);
+        return static_cast<float>(juce::Decibels::gainToDecibels(std::sqrt(variance), -200.0));
+    }
+
+    std::vector<float> calibrate(const CalibrationOptions& options)
+    {
+        const float blendGainDb = juce::Decibels::gainToDecibels(options.blendGain);
+
+        std::vector<float> table;
+        table.reserve(static_cast<size_t>(numAlgorithms * numDriveSteps));
+
+        for (int algorithm = 0; algorithm < numAlgorithms; ++algorithm)
+        {
+            for (int step = 0; step < numDriveSteps; ++step)
+            {
+                const float outputDb = measureOutputLevelDb(algorithm, getDriveForStep(step), options) + blendGainDb;
+                table.push_back(juce::jlimit(-options.maxCompensationDb, options.maxCompensationDb,
+                                             options.referenceLevelDb - outputDb));
+            }
+        }
+
+        return table;
+    }
+
+    juce::String formatTableSource(const std::vector<float>& compensationDb, const CalibrationOptions& options)
+    {
+        jassert(compensationDb.size() == static_cast<size_t>(numAlgorithms * numDriveSteps));
+
+        const auto& names = getAlgorithmNames();
+
+        juce::String source;
+        source << "// Generated by OrbitXRender --calibrate. Do not edit by hand; re-run the tool after changing a curve." << juce::newLine
+               << "// Reference programme: " << juce::String(options.referenceLevelDb, 1) << " dBFS RMS multi-tone at "
+               << juce::String(options.sampleRate, 0) << " Hz, corner blend gain " << juce::String(options.blendGain, 2) << "." << juce::newLine
+               << "#pragma once" << juce::newLine
+               << juce::newLine
+               << "namespace JackDistortion::Loudness::Generated" << juce::newLine
+               << "{" << juce::newLine
+               << "    // Compensation in dB. One row per algorithm in registry order, one column per PostXYDrive step ("
+               << juce::String(minDrive, 0) << " .. " << juce::String(maxDrive, 0) << ")." << juce::newLine
+               << "    constexpr float compensationDb[" << numAlgorithms << "][" << numDriveSteps << "] =" << juce::newLine
+               << "    {" << juce::newLine;
+
+        for (int algorithm = 0; algorithm < numAlgorithms; ++algorithm)
+        {
+            source << "        {";
+            for (int step = 0; step < numDriveSteps; ++step)
+            {
+                const float value = compensationDb[static_cast<size_t>(algorithm * numDriveSteps + step)];
+                source << (step == 0 ? " " : ", ") << juce::String(value, 2) << "f";
+            }
+            source << " }," << " // " << names[algorithm] << juce::newLine;
+        }
+
+        source << "    };" << juce::newLine
+               << "}" << juce::newLine;
+
+        return source;
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "distortion.h"
+
+//==============================================================================
+// Static loudness compensation for the distortion algorithms.
+//
+// Each algorithm's output level is measured offline across the PostXYDrive range with a fixed
+// reference programme, and the gain that brings it back to the input level is stored in a small
+// generated table (LoudnessCompensationTable.h, written by OrbitXRender --calibrate). At run time
+// the processor looks up one gain per corner per block and folds it into the corner weights, so
+// level matching costs a multiply per corner instead of a running RMS measurement.
+namespace JackDistortion::Loudness
+{
+    // Table columns: one per whole PostXYDrive step, interpolated linearly in dB in between.
+    constexpr float minDrive = 1.0f;
+    constexpr float maxDrive = 10.0f;
+    constexpr int numDriveSteps = 10;
+
+    /** Compensation in dB for an algorithm (registry index) at a PostXYDrive value. */
+    float getCompensationDb(int algorithm, float drive);
+
+    inline float getCompensationGain(int algorithm, float drive)
+    {
+        return juce::Decibels::decibelsToGain(getCompensationDb(algorithm, drive));
+    }
+
+    //==============================================================================
+    // Calibration, used by the offline tool only.
+
+    struct CalibrationOptions
+    {
+        double sampleRate = 48000.0;
+        int lengthInSamples = 96000;
+        float referenceLevelDb = -18.0f; // RMS of the reference programme, in dBFS
+        float blendGain = 0.25f;         // the processor scales the corner blend by this
+        float maxCompensationDb = 40.0f;
+    };
+
+    /** Reference programme: a fixed multi-tone spread over the audio band at the given RMS level.
+        It uses no random numbers, so every platform calibrates against the same signal. */
+    void fillReferenceProgramme(juce::AudioBuffer<float>& buffer, double sampleRate, float levelDb);
+
+    /** RMS level in dBFS of an algorithm's response to the reference programme. DC is removed
+        before measuring, since it carries no loudness (rectify, the soft clip offset). */
+    float measureOutputLevelDb(int algorithm, float drive, const CalibrationOptions& options);
+
+    /** Compensation in dB for every algorithm and drive step, row-major by algorithm. */
+    std::vector<float> calibrate(const CalibrationOptions& options);
+
+    /** The table as the source of LoudnessCompensationTable.h. */
+    juce::String formatTableSource(const std::vector<float>& compensationDb, const CalibrationOptions& options);
+}
@@ -0,0 +1,28 @@
+// Generated by OrbitXRender --calibrate. Do not edit by hand; re-run the tool after changing a curve.
+// Reference programme: -18.0 dBFS RMS multi-tone at 48000 Hz, corner blend gain 0.25.
+#pragma once
+
+namespace JackDistortion::Loudness::Generated
+{
+    // Compensation in dB. One row per algorithm in registry order, one column per PostXYDrive step (1 .. 10).
+    constexpr float compensationDb[17][10] =
+    {
+        { 2.81f, 2.58f, 2.37f, 2.17f, 1.99f, 1.82f, 1.67f, 1.52f, 1.39f, 1.27f }, // Soft Clip
+        { -0.54f, -0.77f, -0.98f, -1.15f, -1.31f, -1.44f, -1.56f, -1.66f, -1.75f, -1.83f }, // Hard Clip
+        { -1.63f, -2.43f, -3.18f, -3.88f, -4.50f, -5.05f, -5.51f, -5.88f, -6.14f, -6.32f }, // Sinusoidal Fold
+        { 11.59f, 10.73f, 9.91f, 9.14f, 8.42f, 7.79f, 7.23f, 6.78f, 6.40f, 6.01f }, // Wave Shaped
+        { -4.68f, -4.96f, -5.23f, -5.47f, -5.70f, -5.91f, -6.10f, -6.28f, -6.44f, -6.59f }, // Arctan
+        { -3.20f, -3.58f, -3.93f, -4.26f, -4.57f, -4.86f, -5.12f, -5.37f, -5.60f, -5.81f }, // Asymmetrical Arctan
+        { 6.91f, 5.99f, 5.07f, 4.18f, 3.31f, 2.46f, 1.64f, 0.85f, 0.09f, -0.63f }, // Cascade
+        { 11.51f, 10.64f, 9.79f, 8.99f, 8.23f, 7.54f, 6.92f, 6.38f, 5.90f, 5.44f }, // Polynomial
+        { 15.52f, 14.52f, 13.52f, 12.52f, 11.52f, 10.52f, 9.52f, 8.52f, 7.52f, 6.52f }, // Rectify
+        { -0.18f, -0.83f, -1.47f, -2.10f, -2.71f, -3.30f, -3.87f, -4.43f, -4.97f, -5.50f }, // Logarithmic
+        { 11.02f, 10.03f, 9.03f, 8.03f, 7.03f, 6.03f, 5.04f, 4.04f, 3.04f, 2.04f }, // Bitcrusher
+        { 9.26f, 8.30f, 7.35f, 6.40f, 5.47f, 4.54f, 3.63f, 2.72f, 1.81f, 0.87f }, // Cubic
+        { 5.23f, 4.25f, 3.27f, 2.29f, 1.33f, 0.37f, -0.58f, -1.51f, -2.42f, -3.31f }, // Diode
+        { 7.69f, 6.73f, 5.78f, 4.85f, 3.94f, 3.05f, 2.19f, 1.37f, 0.59f, -0.13f }, // Tube
+        { 9.79f, 9.50f, 9.12f, 8.65f, 8.14f, 7.57f, 6.95f, 6.26f, 5.51f, 4.72f }, // Chebyshev
+        { 11.04f, 10.04f, 9.04f, 8.04f, 7.04f, 6.04f, 5.04f, 4.04f, 3.04f, 2.04f }, // Lofi
+        { 11.04f, 10.04f, 9.04f, 8.04f, 7.04f, 6.04f, 5.04f, 4.05f, 3.08f, 2.17f }, // Wavefolder
+    };
+}
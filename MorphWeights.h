@@ -0,0 +1,77 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+namespace JackDistortion {
+
+// Corner order used by the XY morph: right, top, left, bottom.
+enum Corner { cornerRight = 0, cornerTop, cornerLeft, cornerBottom, numCorners };
+
+using CornerWeights = std::array<float, numCorners>;
+
+// The Distortion_* choice parameter behind each corner, with the ParameterID version it was made with
+// and the name hosts show for it.
+struct CornerParameter
+{
+    const char* id;
+    int version;
+    const char* name;
+};
+
+inline constexpr std::array<CornerParameter, numCorners> cornerParameters {{ { "Distortion_Right", 17, "Distortion Right" },
+                                                                              { "Distortion_Top", 18, "Distortion Top" },
+                                                                              { "Distortion_Left", 19, "Distortion Left" },
+                                                                              { "Distortion_Bottom", 20, "Distortion Bottom" } }};
+
+//------------------------------------------------------------------------------------------------------------//
+// Target blend weights for an effective XY position (both 0..1). The weights sum to 1; at the centre
+// every corner gets a quarter, towards the edge the corner nearest in angle dominates.
+inline CornerWeights computeMorphWeights(float effectiveX, float effectiveY)
+{
+    float centeredX = (effectiveX - 0.5f) * 2.0f;
+    float centeredY = (effectiveY - 0.5f) * 2.0f;
+
+    float radius = std::min(1.0f, std::sqrt(centeredX * centeredX + centeredY * centeredY));
+    float angle = std::atan2(centeredY, centeredX);
+    if (angle < 0)
+        angle += juce::MathConstants<float>::twoPi;
+
+    // Define ideal angles.
+    const CornerWeights idealAngles { 0.0f,                                        // right
+                                      3.0f * juce::MathConstants<float>::halfPi,   // top
+                                      juce::MathConstants<float>::pi,              // left
+                                      juce::MathConstants<float>::halfPi };        // bottom
+
+    auto angleDiff = [](float a, float b) -> float {
+        float diff = std::fmod(b - a + juce::MathConstants<float>::pi,
+                               2.0f * juce::MathConstants<float>::twoPi) - juce::MathConstants<float>::pi;
+        return std::abs(diff);
+    };
+
+    const float sharpness = 2.0f;
+    CornerWeights raw {};
+    float sumRaw = 0.0f;
+    for (int c = 0; c < numCorners; ++c)
+    {
+        float diff = angleDiff(idealAngles[c], angle);
+        raw[c] = std::exp(-sharpness * diff * diff);
+        sumRaw += raw[c];
+    }
+
+    const float centerWeight = 0.25f;
+    CornerWeights weights {};
+    float totalW = 0.0f;
+    for (int c = 0; c < numCorners; ++c)
+    {
+        weights[c] = (1.0f - radius) * centerWeight + radius * (raw[c] / sumRaw);
+        totalW += weights[c];
+    }
+
+    for (auto& w : weights)
+        w /= totalW;
+
+    return weights;
+}
+
+} // namespace JackDistortion
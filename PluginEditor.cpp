@@ -12,7 +12,7 @@ OrbitXAudioProcessorEditor::OrbitXAudioProcessorEditor(OrbitXAudioProcessor& p)
     lnf = std::make_unique<JackGraphics::SimpleLnF>();
     juce::LookAndFeel::setDefaultLookAndFeel(lnf.get());
 
-    presetPanel = std::make_unique<Gui::PresetPanel>(p.getPresetManager());
+    presetPanel = std::make_unique<Gui::PresetPanel>(p.getPresetManager(), p.previewPlayer);
     addAndMakeVisible(*presetPanel);
 
     lfoXContainer = std::make_unique<LFOContainer>(audioProcessor, "LFO X", "LFO_X", audioProcessor.getLFOX());
@@ -20,16 +20,6 @@ OrbitXAudioProcessorEditor::OrbitXAudioProcessorEditor(OrbitXAudioProcessor& p)
     addAndMakeVisible(*lfoXContainer);
     addAndMakeVisible(*lfoYContainer);
     
-    titleText = juce::ImageFileFormat::loadFrom (
-                    BinaryData::titleShine_png,
-                    BinaryData::titleShine_pngSize);
-
-    if (titleText.isValid())
-    {
-        titleWidth  = titleText.getWidth();
-        titleHeight = titleText.getHeight();
-    }
-
     setSize(850, 850); // initial
     setResizeLimits(600, 600, 1600, 1600); // allow small but still usable
     setResizable(true, true); // allow dragging to resize
@@ -184,28 +174,29 @@ void OrbitXAudioProcessorEditor::paint(juce::Graphics& g)
 
 void OrbitXAudioProcessorEditor::drawTitle (juce::Graphics& g)
 {
-    if (! titleText.isValid())
+    // Only the variant this display needs is decoded. ImageCache keeps it for every open editor,
+    // so reopening or opening more editors does not decode it again.
+    const bool hiDpi = g.getInternalContext().getPhysicalPixelScaleFactor() > 1.0f;
+    auto& image = hiDpi ? titleText2x : titleText;
+    if (image.isNull())
+        image = hiDpi ? juce::ImageCache::getFromMemory (BinaryData::titleShine_2x_png, BinaryData::titleShine_2x_pngSize)
+                      : juce::ImageCache::getFromMemory (BinaryData::titleShine_1x_png, BinaryData::titleShine_1x_pngSize);
+
+    if (! image.isValid())
         return;
 
     const int leftMargin      = 10;  // 10px in from left edge
     const int verticalSpacing = -40;   // px gap below LFO container
 
-    const int drawW = titleWidth  / 10;
-    const int drawH = titleHeight / 10;
-
     // find the bottom of the LFO Y container
     int lfoBottom = lfoYContainer
                       ? lfoYContainer->getBounds().getBottom()
-                      : (getHeight() - drawH - verticalSpacing);
+                      : (getHeight() - titleHeight - verticalSpacing);
 
     int x = leftMargin;
     int y = lfoBottom + verticalSpacing;
 
-    g.drawImage (titleText,
-                 x, y,
-                 drawW, drawH,
-                 0, 0,
-                 titleWidth, titleHeight);
+    g.drawImage (image, juce::Rectangle<int> (x, y, titleWidth, titleHeight).toFloat());
 }
 
 void OrbitXAudioProcessorEditor::resized()
@@ -25,9 +25,11 @@ public:
 
 private:
     OrbitXAudioProcessor& audioProcessor;
-    juce::Image titleText;
-    int titleWidth = 0;
-    int titleHeight = 0;
+    // The title is drawn at a fixed size. Assets/titleShine_1x.png and _2x.png are the artwork
+    // pre-scaled to exactly that size and twice it, so painting never resamples the image.
+    static constexpr int titleWidth  = 192;
+    static constexpr int titleHeight = 108;
+    juce::Image titleText, titleText2x;   // decoded on first paint, shared through juce::ImageCache
     
     void drawTitle (juce::Graphics& g);
 
@@ -3,6 +3,53 @@
 #include "distortion.h"
 #include "LFOdsp.h"
 #include "LFOContainer.h"
+#include "LoudnessCompensation.h"
+
+namespace
+{
+    // Sum of squares with SIMD accumulation; unaligned head and tail samples are done one by one.
+    float sumOfSquares(const float* data, int numSamples)
+    {
+        float sum = 0.0f;
+        int i = 0;
+
+       #if JUCE_USE_SIMD
+        using Vec = juce::dsp::SIMDRegister<float>;
+        const auto misalignment = reinterpret_cast<std::uintptr_t>(data) % Vec::SIMDRegisterSize;
+        const int head = juce::jmin(numSamples, misalignment == 0 ? 0 : static_cast<int>((Vec::SIMDRegisterSize - misalignment) / sizeof(float)));
+
+        for (; i < head; ++i)
+            sum += data[i] * data[i];
+
+        auto accumulator = Vec::expand(0.0f);
+        for (; i + static_cast<int>(Vec::SIMDNumElements) <= numSamples; i += static_cast<int>(Vec::SIMDNumElements))
+        {
+            const auto v = Vec::fromRawArray(data + i);
+            accumulator += v * v;
+        }
+        sum += accumulator.sum();
+       #endif
+
+        for (; i < numSamples; ++i)
+            sum += data[i] * data[i];
+
+        return sum;
+    }
+
+    // Measures the enclosing scope and passes the seconds it took to a callback on the way out,
+    // whichever return it leaves by.
+    template <typename Callback>
+    class ScopedBlockTimer
+    {
+    public:
+        explicit ScopedBlockTimer(Callback callbackToUse) : callback(std::move(callbackToUse)) {}
+        ~ScopedBlockTimer() { callback(juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks)); }
+
+    private:
+        Callback callback;
+        const juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+    };
+}
 
 //==============================================================================
 OrbitXAudioProcessor::OrbitXAudioProcessor() :
@@ -10,6 +57,8 @@ OrbitXAudioProcessor::OrbitXAudioProcessor() :
             .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
             .withOutput ("Output", juce::AudioChannelSet::stereo(), true)),
                 apvts(*this, nullptr, "Parameters", createParameterLayout()),
+                stateFormat(apvts),
+                cachedState(stateFormat, apvts),
                 presetManager(std::make_unique<Service::PresetManager>(apvts))
 {
 //    depthParam = apvts.getRawParameterValue("LFO_Depth");
@@ -25,9 +74,20 @@ OrbitXAudioProcessor::OrbitXAudioProcessor() :
 
     bypassParamX = apvts.getRawParameterValue("LFO_X_Bypass");
     bypassParamY = apvts.getRawParameterValue("LFO_Y_Bypass");
+
+    levelModeParam = apvts.getRawParameterValue("LevelMode");
+    qualityParam = apvts.getRawParameterValue("Quality");
+    renderQualityParam = apvts.getRawParameterValue("RenderQuality");
+    adaptiveQualityParam = apvts.getRawParameterValue("AdaptiveQuality");
+
+    for (int corner = 0; corner < JackDistortion::numCorners; ++corner)
+        cornerAlgorithmParams[static_cast<size_t>(corner)] = apvts.getRawParameterValue(JackDistortion::cornerParameters[static_cast<size_t>(corner)].id);
     
     apvts.state.setProperty(Service::PresetManager::presetNameProperty, "", nullptr);
     apvts.state.setProperty("version", ProjectInfo::versionString, nullptr);
+
+    // Queries the CPU now rather than on the first audio callback.
+    JackDistortion::Kernels::getInstructionSet();
 }
 
 OrbitXAudioProcessor::~OrbitXAudioProcessor()
@@ -44,6 +104,13 @@ juce::AudioProcessorValueTreeState::ParameterLayout OrbitXAudioProcessor::create
 {
     using namespace juce;
     
+    // Hosts build a layout for every instance they scan or restore, so the choice lists are made
+    // once per process and shared; each parameter only takes a reference-counted copy.
+    static const StringArray noteDivisions { "1/32", "1/16", "1/16T", "1/8", "1/8T", "1/4", "1/4T",
+                                             "1/2", "1/2T", "1", "2", "4", "8", "16" };
+    static const StringArray lfoShapes { "Sine", "Triangle", "Square", "Saw", "Random" };
+    static const StringArray qualityTiers { "Eco", "Normal", "HQ" };
+
     APVTS::ParameterLayout layout;
     auto checkParam = [](const std::string& id)
     {
@@ -80,12 +147,11 @@ juce::AudioProcessorValueTreeState::ParameterLayout OrbitXAudioProcessor::create
     checkParam("LFO_X_NoteDivision");
     layout.add(std::make_unique<AudioParameterChoice>(
         ParameterID("LFO_X_NoteDivision", 8), "LFO X Note Division",
-        StringArray{"1/32", "1/16", "1/16T", "1/8", "1/8T", "1/4", "1/4T",
-                    "1/2", "1/2T", "1", "2", "4", "8", "16"}, 5));
+        noteDivisions, 5));
     checkParam("LFO_X_Shape");
     layout.add(std::make_unique<AudioParameterChoice>(
         ParameterID("LFO_X_Shape", 9), "LFO X Shape",
-        StringArray{"Sine", "Triangle", "Square", "Saw", "Random"}, 0));
+        lfoShapes, 0));
 
     checkParam("LFO_Y_Depth");
     layout.add(std::make_unique<AudioParameterFloat>(
@@ -101,12 +167,11 @@ juce::AudioProcessorValueTreeState::ParameterLayout OrbitXAudioProcessor::create
     checkParam("LFO_Y_NoteDivision");
     layout.add(std::make_unique<AudioParameterChoice>(
         ParameterID("LFO_Y_NoteDivision", 13), "LFO Y Note Division",
-        StringArray{"1/32", "1/16", "1/16T", "1/8", "1/8T", "1/4", "1/4T",
-                    "1/2", "1/2T", "1", "2", "4", "8", "16"}, 5));
+        noteDivisions, 5));
     checkParam("LFO_Y_Shape");
     layout.add(std::make_unique<AudioParameterChoice>(
         ParameterID("LFO_Y_Shape", 14), "LFO Y Shape",
-        StringArray{"Sine", "Triangle", "Square", "Saw", "Random"}, 0));
+        lfoShapes, 0));
 
     checkParam("LFO_X_Bypass");
     layout.add(std::make_unique<AudioParameterBool>(
@@ -116,46 +181,54 @@ juce::AudioProcessorValueTreeState::ParameterLayout OrbitXAudioProcessor::create
         ParameterID("LFO_Y_Bypass", 16), "LFO Y Bypass", false));
 
     // Distortion parameters – use a default of 0 (Soft Clip)
-    checkParam("Distortion_Right");
-    layout.add(std::make_unique<AudioParameterChoice>(
-        ParameterID("Distortion_Right", 17), "Distortion Right",
-        StringArray{"Soft Clip", "Hard Clip", "Sinusoidal Fold", "Wave Shaped",
-                    "Arctan", "Asymmetrical Arctan", "Cascade", "Polynomial",
-                    "Rectify", "Logarithmic", "Bitcrusher", "Cubic", "Diode", "Tube", "Chebyshev", "Lofi", "Wavefolder"}, 0));
-    checkParam("Distortion_Top");
+    for (const auto& corner : JackDistortion::cornerParameters)
+    {
+        checkParam(corner.id);
+        layout.add(std::make_unique<AudioParameterChoice>(
+            ParameterID(corner.id, corner.version), corner.name,
+            JackDistortion::getAlgorithmNames(), 0));
+    }
+
+    // Output level matching: runtime auto-gain, the calibrated per-algorithm table, or none.
+    checkParam("LevelMode");
     layout.add(std::make_unique<AudioParameterChoice>(
-        ParameterID("Distortion_Top", 18), "Distortion Top",
-        StringArray{"Soft Clip", "Hard Clip", "Sinusoidal Fold", "Wave Shaped",
-                    "Arctan", "Asymmetrical Arctan", "Cascade", "Polynomial",
-                    "Rectify", "Logarithmic", "Bitcrusher", "Cubic", "Diode", "Tube", "Chebyshev", "Lofi", "Wavefolder"}, 0));
-    checkParam("Distortion_Left");
+        ParameterID("LevelMode", 21), "Level Mode",
+        StringArray{"Auto Gain", "Calibrated", "Off"}, 0));
+
+    // Engine quality: Eco for tracking many instances, HQ for bounces. The render tier is used
+    // whenever the host processes offline.
+    checkParam("Quality");
     layout.add(std::make_unique<AudioParameterChoice>(
-        ParameterID("Distortion_Left", 19), "Distortion Left",
-        StringArray{"Soft Clip", "Hard Clip", "Sinusoidal Fold", "Wave Shaped",
-                    "Arctan", "Asymmetrical Arctan", "Cascade", "Polynomial",
-                    "Rectify", "Logarithmic", "Bitcrusher", "Cubic", "Diode", "Tube", "Chebyshev", "Lofi", "Wavefolder"}, 0));
-    checkParam("Distortion_Bottom");
+        ParameterID("Quality", 22), "Quality",
+        qualityTiers, 1));
+    checkParam("RenderQuality");
     layout.add(std::make_unique<AudioParameterChoice>(
-        ParameterID("Distortion_Bottom", 20), "Distortion Bottom",
-        StringArray{"Soft Clip", "Hard Clip", "Sinusoidal Fold", "Wave Shaped",
-                    "Arctan", "Asymmetrical Arctan", "Cascade", "Polynomial",
-                    "Rectify", "Logarithmic", "Bitcrusher", "Cubic", "Diode", "Tube", "Chebyshev", "Lofi", "Wavefolder"}, 0));
+        ParameterID("RenderQuality", 23), "Render Quality",
+        qualityTiers, 2));
+    // Drops real-time quality a tier at a time while processing runs close to the block's budget.
+    checkParam("AdaptiveQuality");
+    layout.add(std::make_unique<AudioParameterBool>(
+        ParameterID("AdaptiveQuality", 24), "Adaptive Quality", true));
 
     return layout;
 }
 
 void OrbitXAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    juce::MemoryOutputStream mos(destData, true);
-    apvts.state.writeToStream(mos);
+    // Encoded again only when a parameter, state property or extension chunk has changed since
+    // the last call.
+    cachedState.appendTo(destData);
 }
 
 void OrbitXAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-    auto tree = juce::ValueTree::readFromData(data, sizeInBytes);
-    if (tree.isValid()){
-        apvts.replaceState(tree);
-    }
+    // Sessions saved before the binary format hold a ValueTree stream; read() migrates those too.
+    Service::StateFormat::Snapshot snapshot;
+    juce::String error;
+    if (stateFormat.read(data, static_cast<size_t>(juce::jmax(0, sizeInBytes)), snapshot, &error))
+        stateFormat.apply(snapshot);
+    else
+        DBG("Could not restore state: it " + error);
 }
 
 //==============================================================================
@@ -193,31 +266,53 @@ void OrbitXAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock
     bypassParamX = apvts.getRawParameterValue("LFO_X_Bypass");
     bypassParamY = apvts.getRawParameterValue("LFO_Y_Bypass");
 
-    // Initialize per-channel distortion objects.
+    levelModeParam = apvts.getRawParameterValue("LevelMode");
+    qualityParam = apvts.getRawParameterValue("Quality");
+    renderQualityParam = apvts.getRawParameterValue("RenderQuality");
+    adaptiveQualityParam = apvts.getRawParameterValue("AdaptiveQuality");
+
+    // Per-channel distortion state is only rebuilt when the layout or rate actually changes, so
+    // hosts that re-prepare on transport changes or offline bounces keep stateful algorithms intact.
     const int numChannels = getTotalNumInputChannels();
-    channelDistortions.clear();
-    channelDistortions.resize(numChannels);
-    
-    for (int ch = 0; ch < numChannels; ++ch)
+    if (sampleRate != preparedSampleRate)
     {
-        channelDistortions[ch].softClip       = std::make_unique<JackDistortion::softClip>();
-        channelDistortions[ch].hardClip       = std::make_unique<JackDistortion::hardClip>();
-        channelDistortions[ch].sinusoidalFold = std::make_unique<JackDistortion::sinusoidalFold>();
-        channelDistortions[ch].waveShaper     = std::make_unique<JackDistortion::waveShaped>();
-        channelDistortions[ch].arctan         = std::make_unique<JackDistortion::arctan>();
-        channelDistortions[ch].asym           = std::make_unique<JackDistortion::asym>();
-        channelDistortions[ch].cascade        = std::make_unique<JackDistortion::cascade>();
-        channelDistortions[ch].poly           = std::make_unique<JackDistortion::poly>();
-        channelDistortions[ch].rectify        = std::make_unique<JackDistortion::rectify>();
-        channelDistortions[ch].logarithmic    = std::make_unique<JackDistortion::logarithmic>();
-        channelDistortions[ch].bitcrusher     = std::make_unique<JackDistortion::bitcrusher>();
-        channelDistortions[ch].cubic          = std::make_unique<JackDistortion::cubic>();
-        channelDistortions[ch].diode          = std::make_unique<JackDistortion::diode>();
-        channelDistortions[ch].tube           = std::make_unique<JackDistortion::tube>();
-        channelDistortions[ch].chebyshev      = std::make_unique<JackDistortion::chebyshev>();
-        channelDistortions[ch].lofi           = std::make_unique<JackDistortion::lofi>();
-        channelDistortions[ch].wavefolder     = std::make_unique<JackDistortion::wavefolder>();
+        channelDistortions.clear();
+        resetAutoGain();
+        preparedSampleRate = sampleRate;
     }
+    channelDistortions.resize(static_cast<size_t>(numChannels));
+    previewPlayer.prepare(sampleRate);
+
+    // Each corner runs at the rate its algorithm's aliasing calls for; all corners and the dry
+    // path are aligned to the latency of the highest rate, so the reported latency never changes.
+    for (auto& engines : cornerOversamplers)
+        for (auto& oversampler : engines)
+            oversampler.prepare(sampleRate, numChannels, samplesPerBlock);
+    for (auto& output : cornerOutputs)
+        output.setSize(numChannels, samplesPerBlock, false, false, true);
+    for (auto& output : transitionOutputs)
+        output.setSize(numChannels, samplesPerBlock, false, false, true);
+
+    const int latency = cornerOversamplers.front().front().getLatencySamples();
+    dryDelay.setMaximumDelayInSamples(juce::jmax(1, latency));
+    dryDelay.prepare({ sampleRate, static_cast<juce::uint32>(samplesPerBlock), static_cast<juce::uint32>(numChannels) });
+    dryDelay.setDelay(static_cast<float>(latency));
+    setLatencySamples(latency);
+    idleHoldSamples = idleFlushSamples + latency;
+
+    // The incoming engine is only heard once its filters have filled from the real signal.
+    transitionWarmupLength = latency + transitionSettleSamples;
+    transitionFadeLength = juce::jmax(1, juce::roundToInt(sampleRate * transitionFadeSeconds));
+    for (auto& transition : cornerTransitions)
+        transition.active = false;
+
+    adaptiveQuality.prepare(sampleRate);
+    applyQuality(getRequestedQuality());
+    syncCornerAlgorithms(false);
+
+    // Shared, read-only tables; built once per process on the cache's background thread.
+    morphWeightTable = tableCache->requestMorphWeights();
+
     smoothedX.reset(sampleRate, 0.3);
     smoothedY.reset(sampleRate, 0.3);
     smoothedX.setCurrentAndTargetValue(*xyXParam);
@@ -232,10 +327,17 @@ void OrbitXAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock
     modulationSmoothX = 10.0f;
     modulationSmoothY = 10.0f;
     
-    smoothedGain.reset(sampleRate, 0.5);     // 0.5 sec smoothing time
-    smoothedGain.setCurrentAndTargetValue(1.0f);
-    smoothedRMS.reset(sampleRate, 0.5);        // 0.5 sec smoothing for RMS
-    smoothedRMS.setCurrentAndTargetValue(0.0f);
+    // Auto-gain coefficients are per control step, so the time constants hold at any block size.
+    auto controlCoeff = [sampleRate](double seconds)
+    {
+        return static_cast<float>(1.0 - std::exp(-autoGainInterval / (seconds * sampleRate)));
+    };
+    autoGainEnvelopeCoeff = controlCoeff(0.5);   // 0.5 sec RMS smoothing
+    autoGainAttackCoeff   = controlCoeff(0.5);
+    autoGainReleaseCoeff  = controlCoeff(1.5);
+    
+    controlRamps.setSize(numControlRamps, samplesPerBlock, false, false, true);
+    preparedBlockSize = samplesPerBlock;
     
     smoothedMix.reset(sampleRate, 0.15);       // Smooth transition time for output mix
     smoothedMix.setCurrentAndTargetValue(1.0f);
@@ -243,6 +345,175 @@ void OrbitXAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock
 
 void OrbitXAudioProcessor::releaseResources() {}
 
+void OrbitXAudioProcessor::reset()
+{
+    resetWetPath();
+    dryDelay.reset();
+
+    resetAutoGain();
+    idleSilentSamples = 0;
+    idleActive = false;
+}
+
+void OrbitXAudioProcessor::resetWetPath()
+{
+    // A transition that was running is finished at once.
+    for (auto& transition : cornerTransitions)
+    {
+        if (transition.active)
+        {
+            transition.liveEngine = 1 - transition.liveEngine;
+            transition.algorithm = transition.nextAlgorithm;
+            transition.active = false;
+        }
+    }
+
+    for (auto& channel : channelDistortions)
+        for (auto& engine : channel.engines)
+            for (auto& slot : engine)
+                slot = JackDistortion::makeDistortion(static_cast<int>(slot.index()));
+
+    for (auto& engines : cornerOversamplers)
+        for (auto& oversampler : engines)
+            oversampler.reset();
+}
+
+void OrbitXAudioProcessor::delayDryPath(juce::AudioBuffer<float>& buffer, int numChannels, int numSamples)
+{
+    if (getLatencySamples() <= 0)
+        return;
+
+    juce::dsp::AudioBlock<float> dryBlock(buffer.getArrayOfWritePointers(), static_cast<size_t>(numChannels),
+                                          static_cast<size_t>(numSamples));
+    dryDelay.process(juce::dsp::ProcessContextReplacing<float>(dryBlock));
+}
+
+void OrbitXAudioProcessor::resetAutoGain()
+{
+    autoGainEnvelope = 0.0f;
+    autoGainTarget = 1.0f;
+    autoGainRampValue = 1.0f;
+    autoGainRampStep = 0.0f;
+    autoGainSumSquares = 0.0f;
+    autoGainSamplesInInterval = 0;
+}
+
+OrbitXAudioProcessor::Quality OrbitXAudioProcessor::getRequestedQuality() const
+{
+    return static_cast<Quality>(static_cast<int>(isNonRealtime() ? *renderQualityParam : *qualityParam));
+}
+
+OrbitXAudioProcessor::QualitySettings OrbitXAudioProcessor::getQualitySettings(Quality quality)
+{
+    QualitySettings settings;
+    switch (quality)
+    {
+        case Quality::eco:
+            settings.oversamplingOffset = -1;
+            settings.weightControlInterval = 128;
+            settings.morphWeightsFromTable = true;
+            break;
+        case Quality::normal:
+            break;
+        case Quality::high:
+            settings.oversamplingOffset = 1;
+            settings.weightControlInterval = 8;
+            settings.allowMorphWeightTable = false;
+            break;
+    }
+    return settings;
+}
+
+OrbitXAudioProcessor::Quality OrbitXAudioProcessor::getEffectiveQuality() const
+{
+    return static_cast<Quality>(juce::jmax(0, static_cast<int>(getRequestedQuality()) - qualityStepsDown.load(std::memory_order_relaxed)));
+}
+
+OrbitXAudioProcessor::QualityState OrbitXAudioProcessor::getQualityState() const
+{
+    return { getRequestedQuality(), getEffectiveQuality(),
+             qualityStepsDown.load(std::memory_order_relaxed), processingLoad.load(std::memory_order_relaxed) };
+}
+
+void OrbitXAudioProcessor::updateAdaptiveQuality(double secondsTaken, int numSamples)
+{
+    // Offline renders may take as long as they need.
+    if (isNonRealtime() || *adaptiveQualityParam < 0.5f)
+    {
+        adaptiveQuality.reset();
+    }
+    else
+    {
+        adaptiveQuality.setMaxStepsDown(static_cast<int>(getRequestedQuality()));
+        adaptiveQuality.update(secondsTaken, numSamples);
+    }
+
+    qualityStepsDown.store(adaptiveQuality.getStepsDown(), std::memory_order_relaxed);
+    processingLoad.store(adaptiveQuality.getLoad(), std::memory_order_relaxed);
+}
+
+void OrbitXAudioProcessor::applyQuality(Quality quality)
+{
+    activeQuality = quality;
+    weightControlInterval = getQualitySettings(quality).weightControlInterval;
+}
+
+void OrbitXAudioProcessor::syncCornerAlgorithms(bool crossfade)
+{
+    distortionRightAlgorithm  = static_cast<int>(*cornerAlgorithmParams[JackDistortion::cornerRight]) + 1;
+    distortionTopAlgorithm    = static_cast<int>(*cornerAlgorithmParams[JackDistortion::cornerTop]) + 1;
+    distortionLeftAlgorithm   = static_cast<int>(*cornerAlgorithmParams[JackDistortion::cornerLeft]) + 1;
+    distortionBottomAlgorithm = static_cast<int>(*cornerAlgorithmParams[JackDistortion::cornerBottom]) + 1;
+
+    const std::array<int, JackDistortion::numCorners> selected { distortionRightAlgorithm, distortionTopAlgorithm,
+                                                                 distortionLeftAlgorithm, distortionBottomAlgorithm };
+
+    // The quality tier shifts every corner's rate except lofi's; the latency stays that of the highest rate.
+    const int oversamplingOffset = getQualitySettings(activeQuality).oversamplingOffset;
+    for (int corner = 0; corner < JackDistortion::numCorners; ++corner)
+    {
+        auto& transition = cornerTransitions[static_cast<size_t>(corner)];
+        if (transition.active)
+            continue;
+
+        const int algorithm = juce::jlimit(0, JackDistortion::numAlgorithms - 1, selected[static_cast<size_t>(corner)] - 1);
+        const int factorLog2 = juce::jlimit(0, JackDistortion::CornerOversampler::maxFactorLog2,
+                                            JackDistortion::getOversamplingFactorLog2(JackDistortion::getAliasingClass(algorithm),
+                                                                                      oversamplingOffset));
+
+        // The oversampler's own rate crossfade runs the engine once per rate, which would step a
+        // stateful curve twice per block. Those change rate through a second engine instead.
+        auto& liveOversampler = cornerOversamplers[static_cast<size_t>(corner)][static_cast<size_t>(transition.liveEngine)];
+        const bool rateChangeNeedsEngine = factorLog2 != liveOversampler.getFactorLog2() && JackDistortion::isStateful(algorithm);
+
+        // Without a crossfade, or for a rate change alone, the live engine switches in place.
+        // Re-seating is a no-op for slots whose selection has not changed.
+        if (! crossfade || (algorithm == transition.algorithm && ! rateChangeNeedsEngine) || channelDistortions.empty())
+        {
+            for (auto& channel : channelDistortions)
+                JackDistortion::emplaceDistortion(channel.engines[static_cast<size_t>(transition.liveEngine)][static_cast<size_t>(corner)],
+                                                  algorithm);
+
+            liveOversampler.setFactorLog2(factorLog2, crossfade);
+            transition.algorithm = algorithm;
+            continue;
+        }
+
+        // The other engine starts clean on the new algorithm and fades in over the next blocks.
+        const int incoming = 1 - transition.liveEngine;
+        for (auto& channel : channelDistortions)
+            channel.engines[static_cast<size_t>(incoming)][static_cast<size_t>(corner)] = JackDistortion::makeDistortion(algorithm);
+
+        auto& oversampler = cornerOversamplers[static_cast<size_t>(corner)][static_cast<size_t>(incoming)];
+        oversampler.reset();
+        oversampler.setFactorLog2(factorLog2);
+
+        transition.nextAlgorithm = algorithm;
+        transition.samplesDone = 0;
+        transition.active = true;
+    }
+}
+
 #ifndef JucePlugin_PreferredChannelConfigurations
 bool OrbitXAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
 {
@@ -260,24 +531,62 @@ bool OrbitXAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) c
 //==============================================================================
 void OrbitXAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    ScopedBlockTimer blockTimer([this, numSamples = buffer.getNumSamples()](double seconds)
+    {
+        updateAdaptiveQuality(seconds, numSamples);
+    });
 
-    
+    // A preset loaded in the background lands here, whole, before anything below reads a parameter.
+    presetManager->applyPendingPreset();
+    const juce::ScopeGuard blockFinished { [this] { presetManager->audioBlockFinished(); } };
+
+    // Whichever way the block returns, a preview playing from the preset browser goes on top.
+    const juce::ScopeGuard mixPreview { [this, &buffer] { previewPlayer.process(buffer); } };
+
+    // A host may send more samples than it promised in prepareToPlay. Such a block runs in
+    // prepared-size pieces, as CornerOversampler::process does, so nothing below is resized here.
+    const int numSamples = buffer.getNumSamples();
+    if (numSamples <= preparedBlockSize)
+    {
+        processChunk(buffer);
+        return;
+    }
+
+    jassert(preparedBlockSize > 0);   // processBlock before prepareToPlay
+    for (int start = 0; preparedBlockSize > 0 && start < numSamples; start += preparedBlockSize)
+    {
+        juce::AudioBuffer<float> chunk(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start,
+                                       juce::jmin(preparedBlockSize, numSamples - start));
+        processChunk(chunk);
+    }
+}
+
+void OrbitXAudioProcessor::processChunk(juce::AudioBuffer<float>& buffer)
+{
     //if (*outputMixParam < 0.001f)
     float rawMix  = *outputMixParam;
     float mixFrac = rawMix * 0.01f;
     smoothedMix.setTargetValue(mixFrac);
     if (mixFrac < 0.001f)
     {
-        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
-            buffer.copyFrom(ch, 0, buffer.getReadPointer(ch), buffer.getNumSamples());
+        // Fully dry, but still delayed by the reported latency. The delay line keeps its history,
+        // so the dry path lines up when the mix comes back.
+        delayDryPath(buffer, juce::jmin(getTotalNumInputChannels(), static_cast<int>(channelDistortions.size())),
+                     buffer.getNumSamples());
+        smoothedMix.skip(buffer.getNumSamples());
+        mixBypassed = true;
         return;
     }
 
+    // The engines have not seen the bypassed blocks; they restart clean as the mix fades back in.
+    if (mixBypassed)
+    {
+        resetWetPath();
+        mixBypassed = false;
+    }
 
-    distortionRightAlgorithm  = static_cast<int>(*apvts.getRawParameterValue("Distortion_Right")) + 1;
-    distortionTopAlgorithm    = static_cast<int>(*apvts.getRawParameterValue("Distortion_Top")) + 1;
-    distortionLeftAlgorithm   = static_cast<int>(*apvts.getRawParameterValue("Distortion_Left")) + 1;
-    distortionBottomAlgorithm = static_cast<int>(*apvts.getRawParameterValue("Distortion_Bottom")) + 1;
+    applyQuality(getEffectiveQuality());
+    syncCornerAlgorithms(true);
     
     playHead = this->getPlayHead();
     if (playHead != nullptr)
@@ -288,6 +597,8 @@ void OrbitXAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce:
     
     juce::ScopedNoDenormals noDenormals;
     auto numSamples = buffer.getNumSamples();
+    if (numSamples == 0)
+        return;
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
     
@@ -369,14 +680,55 @@ void OrbitXAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce:
     smoothedX.setTargetValue(*xyXParam);
     smoothedY.setTargetValue(*xyYParam);
     
+    // --- Distortion Processing ---
+    const float driveValue = *apvts.getRawParameterValue("PostXYDrive");
+    //const float outputMix   = (*apvts.getRawParameterValue("OutputMix")) / 100.0f;
+    //const float outputMix = *outputMixParam;  // now in 0–1
+    const float outputMix = mixFrac;
+
+    // Calibrated mode folds a static per-algorithm gain into each corner's weight instead of
+    // measuring the output; the gains only change with drive or algorithm, so once per block.
+    const auto levelMode = static_cast<LevelMode>(static_cast<int>(*levelModeParam));
+    std::array<float, JackDistortion::numCorners> cornerGains;
+    cornerGains.fill(1.0f);
+    if (levelMode == LevelMode::calibrated)
+    {
+        const std::array<int, JackDistortion::numCorners> selected { distortionRightAlgorithm, distortionTopAlgorithm,
+                                                                     distortionLeftAlgorithm, distortionBottomAlgorithm };
+        for (int corner = 0; corner < JackDistortion::numCorners; ++corner)
+            cornerGains[static_cast<size_t>(corner)] = JackDistortion::Loudness::getCompensationGain(selected[static_cast<size_t>(corner)] - 1,
+                                                                                                     driveValue);
+    }
+
+    float baseX = *xyXParam;
+    float baseY = *xyYParam;
+
+    // The shared weight grid replaces the per-sample trigonometry once it has been built. Eco
+    // always uses it and HQ never does; Normal follows setUseTableLookups().
+    const auto qualitySettings = getQualitySettings(activeQuality);
+    const bool tableWeights = qualitySettings.allowMorphWeightTable
+                           && (qualitySettings.morphWeightsFromTable || useTableLookups.load(std::memory_order_relaxed));
+    const JackDistortion::SharedTable* morphWeightGrid = nullptr;
+    if (tableWeights && morphWeightTable != nullptr && morphWeightTable->isReady())
+        morphWeightGrid = morphWeightTable.get();
+
+    // Silent input skips the engine entirely once its tail has decayed.
+    if (processIdleBlock(buffer, driveValue, cornerGains, levelMode, morphWeightGrid))
+        return;
+    idleActive = false;
+    
     // === FIX: Compute LFO modulation once per sample ===
-    std::vector<float> lfoValuesX(numSamples, 0.0f);
-    std::vector<float> lfoValuesY(numSamples, 0.0f);
+    // Control ramps live in scratch channels sized in prepareToPlay.
+
+    float* lfoValuesX = controlRamps.getWritePointer(rampLfoX);
+    float* lfoValuesY = controlRamps.getWritePointer(rampLfoY);
     
+    const bool lfoXActive = *bypassParamX < 0.5f;
+    const bool lfoYActive = *bypassParamY < 0.5f;
     for (int i = 0; i < numSamples; ++i)
     {
-        float rawModX = (*bypassParamX < 0.5f) ? lfoX.processModulation() : 0.0f;
-        float rawModY = (*bypassParamY < 0.5f) ? lfoY.processModulation() : 0.0f;
+        float rawModX = lfoXActive ? lfoX.processModulation() : 0.0f;
+        float rawModY = lfoYActive ? lfoY.processModulation() : 0.0f;
         
         // Store computed modulation values to use later in per-channel processing.
         lfoValuesX[i] = rawModX;
@@ -385,189 +737,384 @@ void OrbitXAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce:
         // Update modulation smoothing used for XY pad mapping.
         modulationSmoothX += (rawModX - modulationSmoothX) * modulationSmoothingCoeff;
         modulationSmoothY += (rawModY - modulationSmoothY) * modulationSmoothingCoeff;
+    }
+    
+    // Update debug variables (or further processing) as needed.
+    modulatedX = juce::jlimit(0.0f, 1.0f, smoothedX.skip(numSamples) + modulationSmoothX);
+    modulatedY = juce::jlimit(0.0f, 1.0f, smoothedY.skip(numSamples) + modulationSmoothY);
+    lfoXValue.store(lfoValuesX[numSamples - 1], std::memory_order_relaxed);
+    lfoYValue.store(lfoValuesY[numSamples - 1], std::memory_order_relaxed);
+    
+    // --- Corner weights and mix, shared by every channel ---
+    // Weight targets follow the LFOs at control rate; with the LFOs off they only move when the
+    // pad does, and once settled the kernels use them as constants.
+    auto targetWeightsAt = [&](float lfoXValueNow, float lfoYValueNow)
+    {
+        float effectiveX = juce::jlimit(0.0f, 1.0f, baseX + lfoXValueNow);
+        float effectiveY = juce::jlimit(0.0f, 1.0f, baseY + lfoYValueNow);
+        return (morphWeightGrid != nullptr)
+            ? JackDistortion::lookupMorphWeights(morphWeightGrid->data(), JackDistortion::SharedTableCache::morphGridSize,
+                                                 effectiveX, effectiveY)
+            : JackDistortion::computeMorphWeights(effectiveX, effectiveY);
+    };
+    
+    std::array<JackDistortion::BlockSmoothedValue*, JackDistortion::numCorners> weightSmoothers
+        { &smoothedWeightRight, &smoothedWeightTop, &smoothedWeightLeft, &smoothedWeightBottom };
+    auto setWeightTargets = [&weightSmoothers](const JackDistortion::CornerWeights& targets)
+    {
+        for (int corner = 0; corner < JackDistortion::numCorners; ++corner)
+            weightSmoothers[static_cast<size_t>(corner)]->setTargetValue(targets[static_cast<size_t>(corner)]);
+    };
+    
+    const bool modulated = lfoXActive || lfoYActive;
+    if (! modulated)
+        setWeightTargets(targetWeightsAt(0.0f, 0.0f));
+    
+    JackDistortion::Kernels::BlendControls controls;
+    controls.cornerGains = cornerGains;
+    
+    const bool weightsRamping = modulated || std::any_of(weightSmoothers.begin(), weightSmoothers.end(),
+                                                      [](auto* smoother) { return smoother->isSmoothing(); });
+    if (weightsRamping)
+    {
+        for (int start = 0; start < numSamples; start += weightControlInterval)
+        {
+            const int num = juce::jmin(weightControlInterval, numSamples - start);
+            if (modulated)
+                setWeightTargets(targetWeightsAt(lfoValuesX[start + num - 1], lfoValuesY[start + num - 1]));
+            
+            for (int corner = 0; corner < JackDistortion::numCorners; ++corner)
+                weightSmoothers[static_cast<size_t>(corner)]->fillRamp(controlRamps.getWritePointer(rampWeightRight + corner, start), num);
+        }
         
-        float smoothX = smoothedX.getNextValue();
-        float smoothY = smoothedY.getNextValue();
-        
-        float effectiveX = juce::jlimit(0.0f, 1.0f, smoothX + modulationSmoothX);
-        float effectiveY = juce::jlimit(0.0f, 1.0f, smoothY + modulationSmoothY);
-        
-        // Update debug variables (or further processing) as needed.
-        modulatedX = effectiveX;
-        modulatedY = effectiveY;
+        for (int corner = 0; corner < JackDistortion::numCorners; ++corner)
+            controls.weightRamps[static_cast<size_t>(corner)] = controlRamps.getReadPointer(rampWeightRight + corner);
+    }
+    else
+    {
+        for (int corner = 0; corner < JackDistortion::numCorners; ++corner)
+            controls.weights[static_cast<size_t>(corner)] = weightSmoothers[static_cast<size_t>(corner)]->getCurrentValue()
+                                                          * cornerGains[static_cast<size_t>(corner)];
     }
     
-    // --- Distortion Processing ---
-    const float driveValue = *apvts.getRawParameterValue("PostXYDrive");
-    //const float outputMix   = (*apvts.getRawParameterValue("OutputMix")) / 100.0f;
-    //const float outputMix = *outputMixParam;  // now in 0–1
-    const float outputMix = mixFrac;
-
-    float baseX = *xyXParam;
-    float baseY = *xyYParam;
+    const bool mixRamping = smoothedMix.isSmoothing();
+    if (mixRamping)
+    {
+        smoothedMix.fillRamp(controlRamps.getWritePointer(rampMixValues), numSamples);
+        controls.mixRamp = controlRamps.getReadPointer(rampMixValues);
+    }
+    else
+    {
+        controls.mix = smoothedMix.getCurrentValue();
+    }
+    
+    // --- Corner rendering ---
+    // Each corner renders the whole block at its own rate; the dry signal is delayed to match.
+    const int numDistortionChannels = juce::jmin(totalNumInputChannels, static_cast<int>(channelDistortions.size()));
+    for (int corner = 0; corner < JackDistortion::numCorners; ++corner)
+    {
+        auto& output = cornerOutputs[static_cast<size_t>(corner)];
+        for (int channel = 0; channel < numDistortionChannels; ++channel)
+            output.copyFrom(channel, 0, buffer, channel, 0, numSamples);
 
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
-    {
-        auto& distortions = channelDistortions[channel];
-
-        distortions.softClip->setParameters(driveValue, 0.0f);
-        distortions.hardClip->setParameters(driveValue, 0.0f);
-        distortions.sinusoidalFold->setParameters(driveValue, 0.0f);
-        distortions.waveShaper->setParameters(driveValue, 0.0f);
-        distortions.arctan->setParameters(driveValue, 0.0f);
-        distortions.asym->setParameters(driveValue, 0.0f);
-        distortions.cascade->setParameters(driveValue, 0.0f);
-        distortions.poly->setParameters(driveValue, 0.0f);
-        distortions.rectify->setParameters(driveValue, 0.0f);
-        distortions.logarithmic->setParameters(driveValue, 0.0f);
-        distortions.bitcrusher->setParameters(driveValue, 0.0f);
-        distortions.cubic->setParameters(driveValue, 0.0f);
-        distortions.diode->setParameters(driveValue, 0.0f);
-        distortions.tube->setParameters(driveValue, 0.0f);
-        distortions.chebyshev->setParameters(driveValue, 0.0f);
-        distortions.lofi->setParameters(driveValue, 0.0f);
-        distortions.wavefolder->setParameters(driveValue, 0.0f);
-
-        auto* dry = buffer.getReadPointer(channel);
-        auto* wet = buffer.getWritePointer(channel);
-
-        for (int sample = 0; sample < numSamples; ++sample)
+        const auto& transition = cornerTransitions[static_cast<size_t>(corner)];
+        if (transition.active)
         {
-            // === FIX: Use the precomputed LFO modulation values ===
-            float currentLfoX = lfoValuesX[sample];
-            float currentLfoY = lfoValuesY[sample];
-            lfoXValue.store(currentLfoX, std::memory_order_relaxed);
-            lfoYValue.store(currentLfoY, std::memory_order_relaxed);
-            
-            float effectiveX = juce::jlimit(0.0f, 1.0f, baseX + currentLfoX);
-            float effectiveY = juce::jlimit(0.0f, 1.0f, baseY + currentLfoY);
-            
-            float centeredX = (effectiveX - 0.5f) * 2.0f;
-            float centeredY = (effectiveY - 0.5f) * 2.0f;
-            
-            float radius = std::min(1.0f, std::sqrt(centeredX * centeredX + centeredY * centeredY));
-            float angle = std::atan2(centeredY, centeredX);
-            if (angle < 0)
-                angle += juce::MathConstants<float>::twoPi;
-            
-            // Define ideal angles.
-            float idealRight = 0.0f;
-            float idealTop   = 3.0f * juce::MathConstants<float>::halfPi;
-            float idealLeft  = juce::MathConstants<float>::pi;
-            float idealBottom= juce::MathConstants<float>::halfPi;
-            
-            auto angleDiff = [](float a, float b) -> float {
-                float diff = std::fmod(b - a + juce::MathConstants<float>::pi,
-                                       2.0f * juce::MathConstants<float>::twoPi) - juce::MathConstants<float>::pi;
-                return std::abs(diff);
-            };
-            
-            float diffRight = angleDiff(idealRight, angle);
-            float diffTop   = angleDiff(idealTop, angle);
-            float diffLeft  = angleDiff(idealLeft, angle);
-            float diffBottom= angleDiff(idealBottom, angle);
-            
-            float sharpness = 2.0f;
-            float rawRight = std::exp(-sharpness * diffRight * diffRight);
-            float rawTop   = std::exp(-sharpness * diffTop * diffTop);
-            float rawLeft  = std::exp(-sharpness * diffLeft * diffLeft);
-            float rawBottom= std::exp(-sharpness * diffBottom * diffBottom);
-            
-            float sumRaw = rawRight + rawTop + rawLeft + rawBottom;
-            rawRight /= sumRaw;
-            rawTop   /= sumRaw;
-            rawLeft  /= sumRaw;
-            rawBottom/= sumRaw;
-            
-            float centerWeight = 0.25f;
-            float targetWeightRight = (1.0f - radius) * centerWeight + radius * rawRight;
-            float targetWeightTop   = (1.0f - radius) * centerWeight + radius * rawTop;
-            float targetWeightLeft  = (1.0f - radius) * centerWeight + radius * rawLeft;
-            float targetWeightBottom= (1.0f - radius) * centerWeight + radius * rawBottom;
-            
-            float totalW = targetWeightRight + targetWeightTop + targetWeightLeft + targetWeightBottom;
-            targetWeightRight /= totalW;
-            targetWeightTop   /= totalW;
-            targetWeightLeft  /= totalW;
-            targetWeightBottom/= totalW;
-            
-            smoothedWeightRight.setTargetValue(targetWeightRight);
-            smoothedWeightTop.setTargetValue(targetWeightTop);
-            smoothedWeightLeft.setTargetValue(targetWeightLeft);
-            smoothedWeightBottom.setTargetValue(targetWeightBottom);
-            
-            float weightRight = smoothedWeightRight.getNextValue();
-            float weightTop   = smoothedWeightTop.getNextValue();
-            float weightLeft  = smoothedWeightLeft.getNextValue();
-            float weightBottom= smoothedWeightBottom.getNextValue();
-            
-            float inputSample = dry[sample];
-            float outputRight = processDistortionSample(distortionRightAlgorithm, channel, inputSample);
-            float outputTop   = processDistortionSample(distortionTopAlgorithm,   channel, inputSample);
-            float outputLeft  = processDistortionSample(distortionLeftAlgorithm,  channel, inputSample);
-            float outputBottom= processDistortionSample(distortionBottomAlgorithm,channel, inputSample);
-            
-            float blendedSample = (outputRight * weightRight +
-                                   outputTop   * weightTop +
-                                   outputLeft  * weightLeft +
-                                   outputBottom* weightBottom);
-            
-            blendedSample *= 0.25f;
-            float currentOutputMix = smoothedMix.getNextValue();
-            wet[sample] = (blendedSample * currentOutputMix) + (inputSample * (1.0f - currentOutputMix));
+            auto& incoming = transitionOutputs[static_cast<size_t>(corner)];
+            for (int channel = 0; channel < numDistortionChannels; ++channel)
+                incoming.copyFrom(channel, 0, buffer, channel, 0, numSamples);
+
+            renderCorner(corner, 1 - transition.liveEngine, incoming, numDistortionChannels, numSamples, driveValue);
         }
+
+        renderCorner(corner, transition.liveEngine, output, numDistortionChannels, numSamples, driveValue);
+
+        if (transition.active)
+            crossfadeCorner(corner, output, numDistortionChannels, numSamples);
+    }
+
+    delayDryPath(buffer, numDistortionChannels, numSamples);
+
+    for (int channel = 0; channel < numDistortionChannels; ++channel)
+    {
+        for (int corner = 0; corner < JackDistortion::numCorners; ++corner)
+            controls.corners[static_cast<size_t>(corner)] = cornerOutputs[static_cast<size_t>(corner)].getReadPointer(channel);
+
+        JackDistortion::Kernels::blendCorners(buffer.getWritePointer(channel), numSamples, controls);
     }
     
     // --- Post-Distortion Gain Processing ---
-    applyPostDistortionGain(buffer);
+    // Auto-gain restarts from unity whenever it is switched back on.
+    if (levelMode == LevelMode::autoGain)
+    {
+        if (lastLevelMode != LevelMode::autoGain)
+            resetAutoGain();
+        applyPostDistortionGain(buffer);
+    }
+    lastLevelMode = levelMode;
 }
 
-void OrbitXAudioProcessor::applyPostDistortionGain(juce::AudioBuffer<float>& buffer)
+void OrbitXAudioProcessor::renderCorner(int corner, int engine, juce::AudioBuffer<float>& output,
+                                        int numChannels, int numSamples, float drive)
 {
-    if (( *outputMixParam * 0.01f ) < 0.01f)
+    juce::dsp::AudioBlock<float> block(output.getArrayOfWritePointers(), static_cast<size_t>(numChannels),
+                                       static_cast<size_t>(numSamples));
+
+    auto& oversampler = cornerOversamplers[static_cast<size_t>(corner)][static_cast<size_t>(engine)];
+    oversampler.process(block, [this, corner, engine, drive](juce::dsp::AudioBlock<float> atRate)
+    {
+        for (size_t channel = 0; channel < atRate.getNumChannels(); ++channel)
+        {
+            auto& slot = channelDistortions[channel].engines[static_cast<size_t>(engine)][static_cast<size_t>(corner)];
+            float* data = atRate.getChannelPointer(channel);
+            const int num = static_cast<int>(atRate.getNumSamples());
+
+            std::visit([data, num, drive](auto& distortion)
+            {
+                distortion.setParameters(drive, 0.0f);
+
+                // Arithmetic curves run a SIMD register of consecutive samples at a time. The curves
+                // are memoryless, so filling lanes along the sample axis keeps every lane busy whatever
+                // the channel count, with no interleaving.
+                if constexpr (JackDistortion::HasVectorKernel<std::decay_t<decltype(distortion)>>::value)
+                {
+                    distortion.processSamples(data, num);
+                }
+                else
+                {
+                    for (int i = 0; i < num; ++i)
+                        data[i] = distortion.processSample(data[i]);
+                }
+            }, slot);
+        }
+    });
+}
+
+void OrbitXAudioProcessor::crossfadeCorner(int corner, juce::AudioBuffer<float>& output, int numChannels, int numSamples)
+{
+    auto& transition = cornerTransitions[static_cast<size_t>(corner)];
+    const auto& incoming = transitionOutputs[static_cast<size_t>(corner)];
+
+    // Equal-power: the outgoing engine follows a cosine and the incoming one a sine, counted per
+    // sample from the start of the transition so the block size makes no difference.
+    const int fadeStart = transitionWarmupLength - transition.samplesDone;
+    if (fadeStart < numSamples)
+    {
+        const float step = juce::MathConstants<float>::halfPi / static_cast<float>(transitionFadeLength);
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            float* data = output.getWritePointer(channel);
+            const float* next = incoming.getReadPointer(channel);
+
+            for (int i = juce::jmax(0, fadeStart); i < numSamples; ++i)
+            {
+                const float angle = juce::jmin(juce::MathConstants<float>::halfPi, static_cast<float>(i - fadeStart + 1) * step);
+                data[i] = data[i] * std::cos(angle) + next[i] * std::sin(angle);
+            }
+        }
+    }
+
+    transition.samplesDone += numSamples;
+    if (transition.samplesDone >= transitionWarmupLength + transitionFadeLength)
+    {
+        transition.liveEngine = 1 - transition.liveEngine;
+        transition.algorithm = transition.nextAlgorithm;
+        transition.active = false;
+    }
+}
+
+void OrbitXAudioProcessor::updateIdleResponse(const std::array<int, JackDistortion::numCorners>& algorithms, float driveValue,
+                                              const std::array<float, JackDistortion::numCorners>& cornerGains)
+{
+    if (algorithms == idleResponse.algorithms && driveValue == idleResponse.drive && cornerGains == idleResponse.gains)
         return;
-    
+
+    idleResponse.algorithms = algorithms;
+    idleResponse.drive = driveValue;
+    idleResponse.gains = cornerGains;
+    idleResponse.toleratesNoiseFloor = true;
+
+    // Rectify and Chebyshev settle at zero, but Soft Clip's analog offset holds a DC level. Curves
+    // that amplify the noise floor or jump at zero (Soft Clip again, for negative input) are
+    // probed at the threshold, the loudest input that can count as idle, and are then only idle
+    // for exact silence.
+    for (int corner = 0; corner < JackDistortion::numCorners; ++corner)
+    {
+        const auto index = static_cast<size_t>(corner);
+        auto probe = JackDistortion::makeDistortion(algorithms[index]);
+        std::visit([&](auto& distortion)
+        {
+            distortion.setParameters(driveValue, 0.0f);
+            const float atZero = distortion.processSample(0.0f);
+            idleResponse.silentLevel[index] = atZero * cornerGains[index];
+
+            const float deviation = juce::jmax(std::abs(distortion.processSample(idleInputThreshold) - atZero),
+                                               std::abs(distortion.processSample(-idleInputThreshold) - atZero));
+            if (deviation * cornerGains[index] > idleOutputTolerance)
+                idleResponse.toleratesNoiseFloor = false;
+        }, probe);
+    }
+}
+
+bool OrbitXAudioProcessor::processIdleBlock(juce::AudioBuffer<float>& buffer, float driveValue,
+                                            const std::array<float, JackDistortion::numCorners>& cornerGains,
+                                            LevelMode levelMode, const JackDistortion::SharedTable* morphWeightGrid)
+{
     const int numSamples = buffer.getNumSamples();
-    const int numChannels = buffer.getNumChannels();
-    
-    double sumSquares = 0.0;
+    const int numChannels = getTotalNumInputChannels();
+
+    // A corner mid-transition, or mid rate change, has to keep running until it has finished.
+    for (int corner = 0; corner < JackDistortion::numCorners; ++corner)
+    {
+        const auto& transition = cornerTransitions[static_cast<size_t>(corner)];
+        if (transition.active
+            || cornerOversamplers[static_cast<size_t>(corner)][static_cast<size_t>(transition.liveEngine)].isCrossfading())
+        {
+            idleSilentSamples = 0;
+            return false;
+        }
+    }
+
+    float peak = 0.0f;
     for (int ch = 0; ch < numChannels; ++ch)
+        peak = juce::jmax(peak, buffer.getMagnitude(ch, 0, numSamples));
+
+    bool quiet = peak <= idleInputThreshold;
+    if (quiet)
     {
-        const float* data = buffer.getReadPointer(ch);
-        for (int i = 0; i < numSamples; ++i)
-            sumSquares += data[i] * data[i];
+        updateIdleResponse({ distortionRightAlgorithm - 1, distortionTopAlgorithm - 1,
+                             distortionLeftAlgorithm - 1, distortionBottomAlgorithm - 1 },
+                           driveValue, cornerGains);
+        quiet = peak == 0.0f || idleResponse.toleratesNoiseFloor;
     }
-    double meanSquare = sumSquares / (numChannels * numSamples);
-    float measuredRMS = std::sqrt(static_cast<float>(meanSquare));
-    measuredRMS = juce::jmax(measuredRMS, 0.001f);
-    
-    smoothedRMS.setTargetValue(measuredRMS);
-    float smoothRMS = smoothedRMS.getNextValue();
-    
-    float targetRMS = 0.707f;  // ~ -3 dBFS for sine wave
-    float desiredGain = targetRMS / smoothRMS;
-        desiredGain = juce::jlimit(0.01f, 5.0f, desiredGain);
-    //desiredGain = juce::jlimit(0.0f, 10.0f, desiredGain);
-    
-    float currentGain = smoothedGain.getCurrentValue();
-    float sampleRateF = static_cast<float>(getSampleRate());
-    float attackTime = 0.5f;
-    float releaseTime = 1.5f;
-    float attackCoeff = 1.0f - std::exp(-1.0f / (attackTime * sampleRateF));
-    float releaseCoeff = 1.0f - std::exp(-1.0f / (releaseTime * sampleRateF));
-    
-    if (desiredGain > currentGain)
-        currentGain += (desiredGain - currentGain) * attackCoeff;
-    else
-        currentGain += (desiredGain - currentGain) * releaseCoeff;
+    const auto& silentResponse = idleResponse.silentLevel;
+
+    if (! quiet)
+    {
+        idleSilentSamples = 0;
+        return false;
+    }
+
+    // The engine keeps running until every stateful corner (lofi's hold) has flushed its input.
+    if (idleSilentSamples < idleHoldSamples)
+    {
+        idleSilentSamples += numSamples;
+        return false;
+    }
+
+    // The oversamplers and engines were flushed with silence before the idle path took over. The
+    // dry delay keeps running, so it holds this block and not older signal when the engine resumes.
+    delayDryPath(buffer, juce::jmin(numChannels, static_cast<int>(channelDistortions.size())), numSamples);
+
+    // LFOs and smoothers move on by the whole block so the engine resumes in the right place.
+    const bool lfoXActive = *bypassParamX < 0.5f;
+    const bool lfoYActive = *bypassParamY < 0.5f;
+    if (lfoXActive)
+        lfoX.advance(numSamples);
+    if (lfoYActive)
+        lfoY.advance(numSamples);
+
+    const float modX = lfoXActive ? lfoX.getCurrentModulation() : 0.0f;
+    const float modY = lfoYActive ? lfoY.getCurrentModulation() : 0.0f;
+    lfoXValue.store(modX, std::memory_order_relaxed);
+    lfoYValue.store(modY, std::memory_order_relaxed);
+
+    smoothedX.skip(numSamples);
+    smoothedY.skip(numSamples);
+
+    const float effectiveX = juce::jlimit(0.0f, 1.0f, *xyXParam + modX);
+    const float effectiveY = juce::jlimit(0.0f, 1.0f, *xyYParam + modY);
+    modulatedX = effectiveX;
+    modulatedY = effectiveY;
+
+    const auto targetWeights = (morphWeightGrid != nullptr)
+        ? JackDistortion::lookupMorphWeights(morphWeightGrid->data(), JackDistortion::SharedTableCache::morphGridSize,
+                                             effectiveX, effectiveY)
+        : JackDistortion::computeMorphWeights(effectiveX, effectiveY);
+
+    smoothedWeightRight.setTargetValue(targetWeights[JackDistortion::cornerRight]);
+    smoothedWeightTop.setTargetValue(targetWeights[JackDistortion::cornerTop]);
+    smoothedWeightLeft.setTargetValue(targetWeights[JackDistortion::cornerLeft]);
+    smoothedWeightBottom.setTargetValue(targetWeights[JackDistortion::cornerBottom]);
+
+    const float blended = silentResponse[JackDistortion::cornerRight]  * smoothedWeightRight.skip(numSamples)
+                        + silentResponse[JackDistortion::cornerTop]    * smoothedWeightTop.skip(numSamples)
+                        + silentResponse[JackDistortion::cornerLeft]   * smoothedWeightLeft.skip(numSamples)
+                        + silentResponse[JackDistortion::cornerBottom] * smoothedWeightBottom.skip(numSamples);
+    const float level = blended * 0.25f * smoothedMix.skip(numSamples);
+
+    // The output is a DC level (usually zero), ramped from the previous idle block.
+    const float startLevel = idleActive ? idleOutputLevel : level;
+    idleActive = true;
+    idleOutputLevel = level;
+
+    if (startLevel == 0.0f && level == 0.0f)
+    {
+        // Nothing to level-match; auto-gain holds its state for when the signal returns.
+        for (int ch = 0; ch < numChannels; ++ch)
+            buffer.clear(ch, 0, numSamples);
+        return true;
+    }
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        juce::FloatVectorOperations::fill(buffer.getWritePointer(ch), 1.0f, numSamples);
+        buffer.applyGainRamp(ch, 0, numSamples, startLevel, level);
+    }
+
+    if (levelMode == LevelMode::autoGain)
+    {
+        if (lastLevelMode != LevelMode::autoGain)
+            resetAutoGain();
+        applyPostDistortionGain(buffer);
+    }
+    lastLevelMode = levelMode;
+
+    return true;
+}
+
+void OrbitXAudioProcessor::applyPostDistortionGain(juce::AudioBuffer<float>& buffer)
+{
+    if (( *outputMixParam * 0.01f ) < 0.01f)
+        return;
     
-    smoothedGain.setCurrentAndTargetValue(currentGain);
+    const int numSamples = buffer.getNumSamples();
+    const int numChannels = buffer.getNumChannels();
+    const float targetRMS = 0.707f;  // ~ -3 dBFS for sine wave
     
-    for (int ch = 0; ch < numChannels; ++ch)
+    for (int start = 0; start < numSamples;)
     {
-        float* data = buffer.getWritePointer(ch);
-        for (int i = 0; i < numSamples; ++i)
-            data[i] *= currentGain;
+        const int num = juce::jmin(numSamples - start, autoGainInterval - autoGainSamplesInInterval);
+        
+        // Measure before applying the gain, then ramp towards the latest control value.
+        for (int ch = 0; ch < numChannels; ++ch)
+            autoGainSumSquares += sumOfSquares(buffer.getReadPointer(ch, start), num);
+        
+        const float rampEnd = autoGainRampValue + autoGainRampStep * static_cast<float>(num);
+        for (int ch = 0; ch < numChannels; ++ch)
+            buffer.applyGainRamp(ch, start, num, autoGainRampValue, rampEnd);
+        autoGainRampValue = rampEnd;
+        
+        start += num;
+        autoGainSamplesInInterval += num;
+        
+        if (autoGainSamplesInInterval == autoGainInterval)
+        {
+            const float meanSquare = autoGainSumSquares / static_cast<float>(autoGainInterval * juce::jmax(1, numChannels));
+            autoGainEnvelope += (meanSquare - autoGainEnvelope) * autoGainEnvelopeCoeff;
+            
+            const float measuredRMS = juce::jmax(std::sqrt(autoGainEnvelope), 0.001f);
+            const float desiredGain = juce::jlimit(0.01f, 5.0f, targetRMS / measuredRMS);
+            
+            if (desiredGain > autoGainTarget)
+                autoGainTarget += (desiredGain - autoGainTarget) * autoGainAttackCoeff;
+            else
+                autoGainTarget += (desiredGain - autoGainTarget) * autoGainReleaseCoeff;
+            
+            autoGainRampStep = (autoGainTarget - autoGainRampValue) / static_cast<float>(autoGainInterval);
+            autoGainSumSquares = 0.0f;
+            autoGainSamplesInInterval = 0;
+        }
     }
 }
 
@@ -575,42 +1122,9 @@ void OrbitXAudioProcessor::applyPostDistortionGain(juce::AudioBuffer<float>& buf
 void OrbitXAudioProcessor::updateDSP(float drive, float mix)
 {
     for (auto& channel : channelDistortions)
-    {
-        if (channel.softClip)
-            channel.softClip->setParameters(drive, 0.0f);
-        if (channel.hardClip)
-            channel.hardClip->setParameters(drive, 0.0f);
-        if (channel.sinusoidalFold)
-            channel.sinusoidalFold->setParameters(drive, 0.0f);
-        if (channel.waveShaper)
-            channel.waveShaper->setParameters(drive, 0.0f);
-        if (channel.arctan)
-            channel.arctan->setParameters(drive, 0.0f);
-        if (channel.asym)
-            channel.asym->setParameters(drive, 0.0f);
-        if (channel.cascade)
-            channel.cascade->setParameters(drive, 0.0f);
-        if (channel.poly)
-            channel.poly->setParameters(drive, 0.0f);
-        if (channel.rectify)
-            channel.rectify->setParameters(drive, 0.0f);
-        if (channel.logarithmic)
-            channel.logarithmic->setParameters(drive, 0.0f);
-        if (channel.bitcrusher)
-            channel.bitcrusher->setParameters(drive, 0.0f);
-        if (channel.cubic)
-            channel.cubic->setParameters(drive, 0.0f);
-        if (channel.diode)
-            channel.diode->setParameters(drive, 0.0f);
-        if (channel.tube)
-            channel.tube->setParameters(drive, 0.0f);
-        if (channel.chebyshev)
-            channel.chebyshev->setParameters(drive, 0.0f);
-        if (channel.lofi)
-            channel.lofi->setParameters(drive, 0.0f);
-        if (channel.wavefolder)
-            channel.wavefolder->setParameters(drive, 0.0f);
-    }
+        for (auto& engine : channel.engines)
+            for (auto& slot : engine)
+                std::visit([drive](auto& distortion) { distortion.setParameters(drive, 0.0f); }, slot);
 }
 
 //==============================================================================
@@ -626,50 +1140,6 @@ juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
     return new OrbitXAudioProcessor();
 }
 
-float OrbitXAudioProcessor::processDistortionSample(int algID, int channel, float sample)
-{
-    auto& distortions = channelDistortions[channel];
-    switch (algID)
-    {
-        case 1: // Soft Clip Distortion
-            return distortions.softClip->processSample(sample);
-        case 2: // Hard Clip Distortion
-            return distortions.hardClip->processSample(sample);
-        case 3: // Sinusoidal Fold Distortion
-            return distortions.sinusoidalFold->processSample(sample);
-        case 4: // Wave Shaped Distortion
-            return distortions.waveShaper->processSample(sample);
-        case 5: // Arctan Distortion
-            return distortions.arctan->processSample(sample);
-        case 6: // Asymmetrical Arctan Distortion
-            return distortions.asym->processSample(sample);
-        case 7: // Cascade Distortion
-            return distortions.cascade->processSample(sample);
-        case 8: // Polynomial Distortion
-            return distortions.poly->processSample(sample);
-        case 9: // Full Wave Rectify Distortion
-            return distortions.rectify->processSample(sample);
-        case 10: // Logarithmic Distortion
-            return distortions.logarithmic->processSample(sample);
-        case 11: // Bitcrusher Distortion
-            return distortions.bitcrusher->processSample(sample);
-        case 12: // cubic Distortion
-            return distortions.cubic->processSample(sample);
-        case 13: // Diode Distortion
-            return distortions.diode->processSample(sample);
-        case 14: // Tube Distortion
-            return distortions.tube->processSample(sample);
-        case 15: // Chebyshev Distortion
-            return distortions.chebyshev->processSample(sample);
-        case 16: // Lofi Distortion
-            return distortions.lofi->processSample(sample);
-        case 17: // Wavefolder Distortion
-            return distortions.wavefolder->processSample(sample);
-        default:
-            return distortions.softClip->processSample(sample);
-    }
-}
-
 void OrbitXAudioProcessor::setDistortionRightAlgorithm(int alg)
 {
     distortionRightAlgorithm = alg;
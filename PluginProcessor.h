@@ -5,28 +5,22 @@
 #include "LFOdsp.h"
 #include <juce_dsp/juce_dsp.h>
 #include "PresetManager.h"
+#include "StateFormat.h"
+#include "PresetPreviews.h"
+#include "SharedTables.h"
+#include "BlockSmoothedValue.h"
+#include "CornerOversampler.h"
+#include "KernelDispatch.h"
+#include "AdaptiveQuality.h"
 
 //==============================================================================
-// Define a struct to hold per-channel distortion instances.
+// Per-channel distortion state: two engines of one slot per XY corner, each slot holding only the
+// algorithm selected on that corner. One engine is live; the other only runs while its corner
+// crossfades to a new algorithm. Every algorithm fits in the slot's in-place storage, so switching
+// a corner re-seats the slot without allocating and is safe on the audio thread.
 struct ChannelDistortions
 {
-    std::unique_ptr<JackDistortion::softClip>       softClip;
-    std::unique_ptr<JackDistortion::hardClip>       hardClip;
-    std::unique_ptr<JackDistortion::sinusoidalFold>   sinusoidalFold;
-    std::unique_ptr<JackDistortion::waveShaped>       waveShaper;
-    std::unique_ptr<JackDistortion::arctan>           arctan;
-    std::unique_ptr<JackDistortion::asym>             asym;
-    std::unique_ptr<JackDistortion::cascade>          cascade;
-    std::unique_ptr<JackDistortion::poly>             poly;
-    std::unique_ptr<JackDistortion::rectify>          rectify;
-    std::unique_ptr<JackDistortion::logarithmic>      logarithmic;
-    std::unique_ptr<JackDistortion::bitcrusher>       bitcrusher;
-    std::unique_ptr<JackDistortion::cubic>            cubic;
-    std::unique_ptr<JackDistortion::diode>            diode;
-    std::unique_ptr<JackDistortion::tube>             tube;
-    std::unique_ptr<JackDistortion::chebyshev>        chebyshev;
-    std::unique_ptr<JackDistortion::lofi>             lofi;
-    std::unique_ptr<JackDistortion::wavefolder>       wavefolder;
+    std::array<std::array<JackDistortion::AnyDistortion, JackDistortion::numCorners>, 2> engines;
 };
 
 class OrbitXAudioProcessor  : public juce::AudioProcessor
@@ -37,6 +31,7 @@ public:
 
     void prepareToPlay (double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
+    void reset() override;
 
    #ifndef JucePlugin_PreferredChannelConfigurations
     bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
@@ -75,6 +70,13 @@ public:
     using APVTS = juce::AudioProcessorValueTreeState;
     static APVTS::ParameterLayout createParameterLayout();
     APVTS apvts {*this, nullptr, "Parameters", createParameterLayout()};
+
+    /** Reads and writes host state and preset files in the compact binary format. */
+    Service::StateFormat stateFormat { apvts };
+    Service::CachedState cachedState { stateFormat, apvts };
+
+    /** Plays preset previews from the browser over this instance's output. */
+    Service::PreviewPlayer previewPlayer;
     
     void updateDSP(float drive, float mix);
     
@@ -105,6 +107,38 @@ public:
     std::atomic<float>* postXYDriveParam = nullptr;
     std::atomic<float>* outputMixParam = nullptr;
 
+    // How the output level is matched; order follows the LevelMode choice parameter.
+    enum class LevelMode { autoGain = 0, calibrated, off };
+    std::atomic<float>* levelModeParam = nullptr;
+
+    // Engine quality tiers; order follows the Quality and RenderQuality choice parameters.
+    // Quality applies while playing in real time, RenderQuality while the host renders offline.
+    enum class Quality { eco = 0, normal, high };
+    std::atomic<float>* qualityParam = nullptr;
+    std::atomic<float>* renderQualityParam = nullptr;
+
+    std::atomic<float>* adaptiveQualityParam = nullptr;
+
+    // Distortion_* choice per corner, looked up once so the audio thread never builds an ID string.
+    std::array<std::atomic<float>*, JackDistortion::numCorners> cornerAlgorithmParams {};
+
+    /** The tier the parameters ask for now, following isNonRealtime(). */
+    Quality getRequestedQuality() const;
+
+    /** The requested tier lowered by any steps adaptive quality has taken. */
+    Quality getEffectiveQuality() const;
+
+    /** Adaptive quality as seen from the GUI: the tiers, the steps taken and the smoothed share of
+        the real-time budget processBlock uses. Safe to call from any thread. */
+    struct QualityState
+    {
+        Quality requested = Quality::normal;
+        Quality effective = Quality::normal;
+        int stepsDown = 0;
+        float load = 0.0f;
+    };
+    QualityState getQualityState() const;
+
     double getBPM() const;
     
     // LFO DSP instances.
@@ -148,24 +182,20 @@ public:
     float distortionCParam = 0.5f;
     float distortionDParam = 0.5f;
     
-    juce::SmoothedValue<float> smoothedWeightRight;
-    juce::SmoothedValue<float> smoothedWeightTop;
-    juce::SmoothedValue<float> smoothedWeightLeft;
-    juce::SmoothedValue<float> smoothedWeightBottom;
+    JackDistortion::BlockSmoothedValue smoothedWeightRight;
+    JackDistortion::BlockSmoothedValue smoothedWeightTop;
+    JackDistortion::BlockSmoothedValue smoothedWeightLeft;
+    JackDistortion::BlockSmoothedValue smoothedWeightBottom;
     
-    juce::SmoothedValue<float> smoothedX;
-    juce::SmoothedValue<float> smoothedY;
+    JackDistortion::BlockSmoothedValue smoothedX;
+    JackDistortion::BlockSmoothedValue smoothedY;
     float modulationSmoothX = 0.0f;
     float modulationSmoothY = 0.0f;
     const float modulationSmoothingCoeff = 0.05f;
     
-    juce::SmoothedValue<float> smoothedMix;
+    JackDistortion::BlockSmoothedValue smoothedMix;
     
-    juce::SmoothedValue<float> smoothedGain;
-    juce::SmoothedValue<float> smoothedRMS;
     
-    float processDistortionSample(int algID, int channel, float sample);
-
     void setDistortionRightAlgorithm(int alg);
     void setDistortionTopAlgorithm(int alg);
     void setDistortionLeftAlgorithm(int alg);
@@ -177,15 +207,131 @@ public:
     void setDistortionDParameter(float value);
     
     void applyPostDistortionGain(juce::AudioBuffer<float>& buffer);
+    
+    /** Uses the shared lookup tables in place of the analytic XY weight math once they are built.
+        Only the Normal quality tier follows this; Eco always uses them and HQ never does. */
+    void setUseTableLookups(bool shouldUse) { useTableLookups.store(shouldUse); }
+    bool getUseTableLookups() const { return useTableLookups.load(); }
 
 private:
     std::vector<ChannelDistortions> channelDistortions;
+    double preparedSampleRate = 0.0;
+    void syncCornerAlgorithms(bool crossfade);
+    
+    // Per-block control signals, rendered once and shared by every channel. A ramp pointer is only
+    // set when that control is moving; otherwise the blend kernel reads the constant.
+    enum ControlRampChannel { rampWeightRight = 0, rampWeightTop, rampWeightLeft, rampWeightBottom,
+                              rampMixValues, rampLfoX, rampLfoY, numControlRamps };
+    int weightControlInterval = 32;
+    
+    // The engine settings each quality tier bundles. Oversampling is offset from the factor the
+    // corner's aliasing class asks for; control rate is the weight target update interval.
+    struct QualitySettings
+    {
+        int oversamplingOffset = 0;
+        int weightControlInterval = 32;
+        bool morphWeightsFromTable = false;  // eco always uses the shared grid
+        bool allowMorphWeightTable = true;   // HQ never does
+    };
+    static QualitySettings getQualitySettings(Quality quality);
+    Quality activeQuality = Quality::normal;
+    void applyQuality(Quality quality);
+    
+    // Adaptive quality: processBlock times itself and steps the real-time tier down under load.
+    JackDistortion::AdaptiveQuality adaptiveQuality;
+    std::atomic<int> qualityStepsDown { 0 };
+    std::atomic<float> processingLoad { 0.0f };
+    void updateAdaptiveQuality(double secondsTaken, int numSamples);
+    juce::AudioBuffer<float> controlRamps;
+
+    // The scratch buffers are sized for this in prepareToPlay and never resized on the audio
+    // thread; a longer host block is processed in pieces of at most this many samples.
+    int preparedBlockSize = 0;
+    void processChunk(juce::AudioBuffer<float>& buffer);
+    
+    // Per-corner oversampling, one per engine, and the buffers each corner renders into before the blend.
+    std::array<std::array<JackDistortion::CornerOversampler, 2>, JackDistortion::numCorners> cornerOversamplers;
+    std::array<juce::AudioBuffer<float>, JackDistortion::numCorners> cornerOutputs;
+    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::None> dryDelay;
+    void delayDryPath(juce::AudioBuffer<float>& buffer, int numChannels, int numSamples);
+    void resetWetPath();   // engines, oversamplers and transitions; the dry delay is left alone
+    bool mixBypassed = false;   // mix at zero: only the dry delay runs
+    void renderCorner(int corner, int engine, juce::AudioBuffer<float>& output, int numChannels, int numSamples, float drive);
+
+    // Algorithm switching. Both engines of a corner are prepared up front. A new algorithm goes
+    // into the engine that is not live, which runs unheard until its oversampling filters and
+    // state have filled from the real signal, and the corner then crosses over with an
+    // equal-power fade. Only for those few milliseconds does the corner cost twice. A change
+    // requested meanwhile is picked up once the running one has finished.
+    struct CornerTransition
+    {
+        int liveEngine = 0;
+        int algorithm = -1;         // registry index the live engine runs
+        int nextAlgorithm = -1;
+        int samplesDone = 0;        // base-rate samples into the transition
+        bool active = false;
+    };
+    static constexpr int transitionSettleSamples = 64;     // on top of the oversampling latency
+    static constexpr double transitionFadeSeconds = 0.01;
+    int transitionWarmupLength = transitionSettleSamples;
+    int transitionFadeLength = 1;
+    std::array<CornerTransition, JackDistortion::numCorners> cornerTransitions;
+    std::array<juce::AudioBuffer<float>, JackDistortion::numCorners> transitionOutputs;   // the incoming engine's output
+    void crossfadeCorner(int corner, juce::AudioBuffer<float>& output, int numChannels, int numSamples);
+    
+    // Auto-gain: a mean-square envelope updated every autoGainInterval samples, with the gain
+    // ramped per sample between control points so block size has no effect on the result.
+    static constexpr int autoGainInterval = 32;
+    float autoGainEnvelopeCoeff = 0.0f;
+    float autoGainAttackCoeff = 0.0f;
+    float autoGainReleaseCoeff = 0.0f;
+    float autoGainEnvelope = 0.0f;      // smoothed mean square
+    float autoGainTarget = 1.0f;        // gain reached at the end of the current ramp
+    float autoGainRampValue = 1.0f;
+    float autoGainRampStep = 0.0f;
+    float autoGainSumSquares = 0.0f;
+    int autoGainSamplesInInterval = 0;
+    LevelMode lastLevelMode = LevelMode::autoGain;
+    void resetAutoGain();
+
+    // Idle fast path: below idleInputThreshold, and once the engine has flushed idleHoldSamples of
+    // silence (lofi's hold plus the oversampling latency), blocks are rendered as the engine's
+    // settled response without running it.
+    static constexpr float idleInputThreshold = 1.0e-5f;   // about -100 dBFS
+    static constexpr float idleOutputTolerance = 1.0e-5f;
+    static constexpr int idleFlushSamples = 64;
+    int idleHoldSamples = idleFlushSamples;
+    int idleSilentSamples = 0;
+    bool idleActive = false;
+    float idleOutputLevel = 0.0f;
+
+    // Each corner's settled response to silence, and whether input up to idleInputThreshold can
+    // count as silence for it. Worked out from fresh engines when the algorithms, drive or level
+    // gains change, not per block.
+    struct IdleResponse
+    {
+        std::array<int, JackDistortion::numCorners> algorithms { -1, -1, -1, -1 };
+        float drive = -1.0f;
+        std::array<float, JackDistortion::numCorners> gains {};
+        std::array<float, JackDistortion::numCorners> silentLevel {};
+        bool toleratesNoiseFloor = false;
+    };
+    IdleResponse idleResponse;
+    void updateIdleResponse(const std::array<int, JackDistortion::numCorners>& algorithms, float driveValue,
+                            const std::array<float, JackDistortion::numCorners>& cornerGains);
+    bool processIdleBlock(juce::AudioBuffer<float>& buffer, float driveValue,
+                          const std::array<float, JackDistortion::numCorners>& cornerGains,
+                          LevelMode levelMode, const JackDistortion::SharedTable* morphWeightGrid);
     float getLfoFrequencyFromSync(float noteDivisionValue, double bpm);
     void updateHostBPM();
     juce::AudioPlayHead* playHead = nullptr;
     juce::AudioPlayHead::CurrentPositionInfo currentPositionInfo;
     
     std::unique_ptr<Service::PresetManager> presetManager;
+    
+    juce::SharedResourcePointer<JackDistortion::SharedTableCache> tableCache;
+    JackDistortion::SharedTablePtr morphWeightTable;
+    std::atomic<bool> useTableLookups { false };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OrbitXAudioProcessor)
 };
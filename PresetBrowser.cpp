@@ -0,0 +1,209 @@
+#include "PresetBrowser.h"
+#include "distortion.h"
+
+namespace Gui
+{
+
+PresetBrowser::PresetBrowser(Service::PresetManager& pm, Service::PreviewPlayer& player)
+    : presetManager(pm), previewPlayer(player)
+{
+    searchBox.setTextToShowWhenEmpty("Search name, tag or algorithm", juce::Colours::grey);
+    searchBox.setColour(juce::TextEditor::backgroundColourId, juce::Colours::darkgrey.darker(1.5f));
+    searchBox.setColour(juce::TextEditor::textColourId, juce::Colours::white);
+    searchBox.setColour(juce::TextEditor::outlineColourId, juce::Colours::white);
+    searchBox.setColour(juce::TextEditor::focusedOutlineColourId, juce::Colours::white);
+    searchBox.onTextChange = [this] { updateResults(); };
+    searchBox.onReturnKey = [this] { returnKeyPressed(list.getSelectedRow()); };
+    searchBox.onEscapeKey = [this] { close(); };
+    addAndMakeVisible(searchBox);
+
+    list.setRowHeight(rowHeight);
+    list.setColour(juce::ListBox::backgroundColourId, juce::Colours::darkgrey.darker(1.5f));
+    addAndMakeVisible(list);
+
+    presetManager.getPresetIndex().addChangeListener(this);
+    previews->addChangeListener(this);
+    refreshPresets();
+
+    setSize(360, 400);
+}
+
+PresetBrowser::~PresetBrowser()
+{
+    presetManager.getPresetIndex().removeChangeListener(this);
+    previews->removeChangeListener(this);
+    previewPlayer.stop();
+}
+
+void PresetBrowser::paint(juce::Graphics& g)
+{
+    g.fillAll(juce::Colours::darkgrey.darker(1.5f));
+}
+
+void PresetBrowser::resized()
+{
+    auto bounds = getLocalBounds().reduced(4);
+    searchBox.setBounds(bounds.removeFromTop(26));
+    bounds.removeFromTop(4);
+    list.setBounds(bounds);
+}
+
+void PresetBrowser::visibilityChanged()
+{
+    if (isShowing())
+        searchBox.grabKeyboardFocus();
+}
+
+int PresetBrowser::getNumRows()
+{
+    return static_cast<int>(search.getResults().size());
+}
+
+void PresetBrowser::paintListBoxItem(int rowNumber, juce::Graphics& g, int width, int height, bool rowIsSelected)
+{
+    const auto& results = search.getResults();
+    if (! juce::isPositiveAndBelow(rowNumber, static_cast<int>(results.size())))
+        return;
+
+    const auto& preset = search.getPresets()[static_cast<size_t>(results[static_cast<size_t>(rowNumber)])];
+
+    if (rowIsSelected)
+        g.fillAll(juce::Colours::black);
+
+    // The details are only put together for the rows on screen.
+    juce::StringArray details;
+    if (preset.factory)
+        details.add("Factory");
+    if (! preset.tags.isEmpty())
+        details.add(preset.tags.joinIntoString(", "));
+
+    juce::StringArray corners;
+    const auto& algorithmNames = JackDistortion::getAlgorithmNames();
+    for (int algorithm : preset.corners)
+        if (juce::isPositiveAndBelow(algorithm, algorithmNames.size()))
+            corners.add(algorithmNames[algorithm]);
+    if (! corners.isEmpty())
+        details.add(corners.joinIntoString(" / "));
+
+    if (preset.name == auditionedPreset)
+        details = juce::StringArray("Rendering preview...");
+
+    auto area = juce::Rectangle<int>(width, height).reduced(6, 0);
+    auto nameArea = area.removeFromLeft(area.proportionOfWidth(0.45f));
+
+    g.setFont(14.0f);
+    g.setColour(juce::Colours::white);
+    g.drawText(preset.name, nameArea, juce::Justification::centredLeft, true);
+
+    g.setFont(11.0f);
+    g.setColour(juce::Colours::grey);
+    g.drawText(details.joinIntoString(" - "), area, juce::Justification::centredRight, true);
+}
+
+void PresetBrowser::listBoxItemClicked(int row, const juce::MouseEvent&)
+{
+    auditionRow(row);
+}
+
+void PresetBrowser::listBoxItemDoubleClicked(int row, const juce::MouseEvent&)
+{
+    loadRow(row);
+    close();
+}
+
+void PresetBrowser::returnKeyPressed(int lastRowSelected)
+{
+    loadRow(lastRowSelected);
+    close();
+}
+
+void PresetBrowser::changeListenerCallback(juce::ChangeBroadcaster* source)
+{
+    if (source == &presetManager.getPresetIndex())
+        refreshPresets();
+    else
+        playAudition();
+}
+
+void PresetBrowser::refreshPresets()
+{
+    search.setPresets(presetManager.getPresetIndex().getPresetInfos());
+    updateResults();
+}
+
+void PresetBrowser::updateResults()
+{
+    search.search(searchBox.getText());
+    list.updateContent();
+    list.repaint();
+
+    // While searching, return should take the best match; otherwise show where the current preset is.
+    if (searchBox.isEmpty())
+        selectCurrentPreset();
+    else if (getNumRows() > 0)
+        list.selectRow(0);
+    else
+        list.deselectAllRows();
+}
+
+void PresetBrowser::selectCurrentPreset()
+{
+    const auto current = presetManager.getCurrentPreset();
+    const auto& results = search.getResults();
+    const auto& presets = search.getPresets();
+
+    for (size_t row = 0; row < results.size(); ++row)
+    {
+        if (presets[static_cast<size_t>(results[row])].name == current)
+        {
+            list.selectRow(static_cast<int>(row));
+            return;
+        }
+    }
+
+    list.deselectAllRows();
+}
+
+void PresetBrowser::loadRow(int row)
+{
+    const auto& results = search.getResults();
+    if (juce::isPositiveAndBelow(row, static_cast<int>(results.size())))
+        presetManager.loadPreset(search.getPresets()[static_cast<size_t>(results[static_cast<size_t>(row)])].name);
+}
+
+void PresetBrowser::auditionRow(int row)
+{
+    const auto& results = search.getResults();
+    if (! juce::isPositiveAndBelow(row, static_cast<int>(results.size())))
+        return;
+
+    auditionedPreset = search.getPresets()[static_cast<size_t>(results[static_cast<size_t>(row)])].name;
+    playAudition();
+}
+
+void PresetBrowser::playAudition()
+{
+    if (auditionedPreset.isEmpty())
+        return;
+
+    // Not ready yet: the previews report back once it is, and this is called again.
+    if (auto preview = previews->getPreview(auditionedPreset, previewPlayer.getSampleRate()))
+    {
+        previewPlayer.play(std::move(preview));
+        auditionedPreset.clear();
+    }
+    else if (previewPlayer.getSampleRate() <= 0.0)
+    {
+        auditionedPreset.clear();
+    }
+
+    list.repaint();
+}
+
+void PresetBrowser::close()
+{
+    if (auto* callOut = findParentComponentOfClass<juce::CallOutBox>())
+        callOut->dismiss();
+}
+
+} // namespace Gui
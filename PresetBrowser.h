@@ -0,0 +1,61 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "PresetManager.h"
+#include "PresetSearch.h"
+#include "PresetPreviews.h"
+
+namespace Gui
+{
+
+//==============================================================================
+// The preset list the preset panel opens: a search box over a ListBox of the matches. The list
+// only paints the rows on screen, so it opens and scrolls the same with ten or ten thousand
+// presets. It searches a copy of the preset index, refreshed whenever the index changes, and
+// filters on every keystroke. Clicking a preset plays its preview over the plugin's output
+// without loading it; double-clicking it, or pressing return, loads it and closes the browser.
+class PresetBrowser : public juce::Component,
+                      private juce::ListBoxModel,
+                      private juce::ChangeListener
+{
+public:
+    PresetBrowser(Service::PresetManager& pm, Service::PreviewPlayer& player);
+    ~PresetBrowser() override;
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+    void visibilityChanged() override;
+
+private:
+    static constexpr int rowHeight = 22;
+
+    int getNumRows() override;
+    void paintListBoxItem(int rowNumber, juce::Graphics& g, int width, int height, bool rowIsSelected) override;
+    void listBoxItemClicked(int row, const juce::MouseEvent&) override;
+    void listBoxItemDoubleClicked(int row, const juce::MouseEvent&) override;
+    void returnKeyPressed(int lastRowSelected) override;
+
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+
+    void refreshPresets();
+    void updateResults();
+    void selectCurrentPreset();
+    void loadRow(int row);
+    void auditionRow(int row);
+    void playAudition();
+    void close();
+
+    Service::PresetManager& presetManager;
+    Service::PresetSearch search;
+
+    Service::PreviewPlayer& previewPlayer;
+    juce::SharedResourcePointer<Service::PresetPreviews> previews;
+    juce::String auditionedPreset;   // set while its preview is being rendered
+
+    juce::TextEditor searchBox;
+    juce::ListBox list { {}, this };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetBrowser)
+};
+
+} // namespace Gui
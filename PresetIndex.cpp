@@ -0,0 +1,273 @@
+#include "PresetIndex.h"
+#include "PresetManager.h"
+#include "FactoryPresets.h"
+#include "StateFormat.h"
+
+namespace Service
+{
+    namespace
+    {
+        // Natural order ("Bass 2" before "Bass 10"), with case only breaking ties.
+        bool compareNames(const juce::String& a, const juce::String& b)
+        {
+            const int order = a.compareNatural(b);
+            return order != 0 ? order < 0 : a < b;
+        }
+
+        template <typename Entries>
+        auto lowerBound(Entries& entries, const juce::String& presetName)
+        {
+            return std::lower_bound(entries.begin(), entries.end(), presetName,
+                                    [](const auto& e, const juce::String& name) { return compareNames(e.info.name, name); });
+        }
+
+        const std::vector<StateFormat::ParameterKey>& getCornerKeys()
+        {
+            static const std::vector<StateFormat::ParameterKey> keys = []
+            {
+                std::vector<StateFormat::ParameterKey> result;
+                for (const auto& corner : JackDistortion::cornerParameters)
+                    result.push_back({ corner.id, corner.version });
+                return result;
+            }();
+            return keys;
+        }
+    }
+
+    PresetIndex::PresetIndex()
+        : PresetIndex(PresetManager::defaultDirectory)
+    {
+    }
+
+    PresetIndex::PresetIndex(const juce::File& directoryToWatch)
+        : juce::Thread("Preset index"), directory(directoryToWatch)
+    {
+        // The factory bank is in memory, so it can be browsed before the first scan is done.
+        std::vector<Entry> factoryEntries;
+        for (const auto& preset : getFactoryPresets())
+            factoryEntries.push_back(makeEntry(preset.name, {}, true, preset.data, preset.size));
+
+        setEntries(std::move(factoryEntries));
+        startThread();
+    }
+
+    PresetIndex::~PresetIndex()
+    {
+        stopThread(pollIntervalMs + 1000);
+    }
+
+    juce::StringArray PresetIndex::getPresetNames() const
+    {
+        const juce::ScopedLock sl(lock);
+        return names;
+    }
+
+    int PresetIndex::getNumPresets() const
+    {
+        const juce::ScopedLock sl(lock);
+        return names.size();
+    }
+
+    juce::String PresetIndex::getPresetName(int index) const
+    {
+        const juce::ScopedLock sl(lock);
+        return names[index];
+    }
+
+    std::vector<PresetIndex::PresetInfo> PresetIndex::getPresetInfos() const
+    {
+        const juce::ScopedLock sl(lock);
+        std::vector<PresetInfo> infos;
+        infos.reserve(entries.size());
+        for (const auto& e : entries)
+            infos.push_back(e.info);
+        return infos;
+    }
+
+    int PresetIndex::indexOf(const juce::String& presetName) const
+    {
+        const juce::ScopedLock sl(lock);
+        auto it = findEntry(presetName);
+        return it != entries.end() ? static_cast<int>(it - entries.begin()) : -1;
+    }
+
+    bool PresetIndex::isFactoryPreset(const juce::String& presetName) const
+    {
+        const juce::ScopedLock sl(lock);
+        auto it = findEntry(presetName);
+        return it != entries.end() && it->info.factory;
+    }
+
+    std::vector<PresetIndex::Entry>::iterator PresetIndex::findEntry(const juce::String& presetName)
+    {
+        auto it = lowerBound(entries, presetName);
+        return (it != entries.end() && it->info.name == presetName) ? it : entries.end();
+    }
+
+    std::vector<PresetIndex::Entry>::const_iterator PresetIndex::findEntry(const juce::String& presetName) const
+    {
+        auto it = lowerBound(entries, presetName);
+        return (it != entries.end() && it->info.name == presetName) ? it : entries.end();
+    }
+
+    PresetIndex::Entry PresetIndex::makeEntry(const juce::String& name, juce::Time modified, bool factory,
+                                              const void* data, size_t sizeInBytes)
+    {
+        Entry entry;
+        entry.info.name = name;
+        entry.info.factory = factory;
+        entry.modified = modified;
+
+        std::vector<float> values;
+        juce::NamedValueSet properties;
+        if (StateFormat::peek(data, sizeInBytes, getCornerKeys(), values, properties))
+        {
+            for (size_t i = 0; i < values.size(); ++i)
+                entry.info.corners[i] = std::isfinite(values[i]) ? juce::roundToInt(values[i]) : -1;
+
+            entry.info.tags.addTokens(properties["tags"].toString(), ",", "");
+            entry.info.tags.trim();
+            entry.info.tags.removeEmptyStrings();
+        }
+
+        return entry;
+    }
+
+    void PresetIndex::presetSaved(const juce::String& presetName, const void* data, size_t sizeInBytes)
+    {
+        auto entry = makeEntry(presetName, juce::Time::getCurrentTime(), false, data, sizeInBytes);
+        {
+            const juce::ScopedLock sl(lock);
+            auto it = lowerBound(entries, presetName);
+            if (it != entries.end() && it->info.name == presetName)
+            {
+                *it = std::move(entry);
+            }
+            else
+            {
+                const auto position = static_cast<int>(it - entries.begin());
+                entries.insert(it, std::move(entry));
+                names.insert(position, presetName);
+            }
+        }
+        sendChangeMessage();
+    }
+
+    void PresetIndex::presetDeleted(const juce::String& presetName)
+    {
+        {
+            const juce::ScopedLock sl(lock);
+            auto it = findEntry(presetName);
+            if (it == entries.end() || it->info.factory)
+                return;
+
+            // A deleted user preset uncovers the factory preset it was shadowing.
+            if (const auto* factoryPreset = findFactoryPreset(presetName))
+            {
+                *it = makeEntry(presetName, {}, true, factoryPreset->data, factoryPreset->size);
+            }
+            else
+            {
+                names.remove(static_cast<int>(it - entries.begin()));
+                entries.erase(it);
+            }
+        }
+        sendChangeMessage();
+    }
+
+    void PresetIndex::requestRescan()
+    {
+        rescanRequested.store(true);
+        notify();
+    }
+
+    void PresetIndex::run()
+    {
+        while (! threadShouldExit())
+        {
+            // One stat per poll: the directory's own time moves when its entries change.
+            const auto directoryTime = directory.getLastModificationTime();
+            if (! isBuilt() || directoryTime != lastDirectoryTime || rescanRequested.exchange(false))
+            {
+                lastDirectoryTime = directoryTime;
+                rescan();
+            }
+
+            wait(pollIntervalMs);
+        }
+    }
+
+    void PresetIndex::rescan()
+    {
+        // Files whose time has not moved keep the details already read from them.
+        std::vector<Entry> previous;
+        {
+            const juce::ScopedLock sl(lock);
+            previous = entries;
+        }
+
+        std::vector<Entry> scanned;
+        juce::MemoryBlock data;
+        for (const auto& entry : juce::RangedDirectoryIterator(directory, false, "*." + PresetManager::extension,
+                                                                juce::File::findFiles))
+        {
+            if (threadShouldExit())
+                return;
+
+            const auto name = entry.getFile().getFileNameWithoutExtension();
+            const auto modified = entry.getModificationTime();
+
+            auto known = lowerBound(previous, name);
+            if (known != previous.end() && known->info.name == name && ! known->info.factory && known->modified == modified)
+            {
+                scanned.push_back(*known);
+                continue;
+            }
+
+            data.reset();
+            entry.getFile().loadFileAsData(data);
+            scanned.push_back(makeEntry(name, modified, false, data.getData(), data.getSize()));
+        }
+
+        std::sort(scanned.begin(), scanned.end(), [](const Entry& a, const Entry& b) { return compareNames(a.info.name, b.info.name); });
+
+        for (const auto& preset : getFactoryPresets())
+        {
+            auto it = lowerBound(scanned, preset.name);
+            if (it == scanned.end() || it->info.name != preset.name)
+                scanned.insert(it, makeEntry(preset.name, {}, true, preset.data, preset.size));
+        }
+
+        publish(std::move(scanned));
+    }
+
+    void PresetIndex::publish(std::vector<Entry> newEntries)
+    {
+        {
+            const juce::ScopedLock sl(lock);
+            const bool unchanged = isBuilt() && newEntries.size() == entries.size()
+                                && std::equal(newEntries.begin(), newEntries.end(), entries.begin(),
+                                              [](const Entry& a, const Entry& b)
+                                              {
+                                                  return a.info.name == b.info.name && a.modified == b.modified
+                                                      && a.info.factory == b.info.factory;
+                                              });
+            if (unchanged)
+                return;
+
+            setEntries(std::move(newEntries));
+        }
+
+        built.store(true, std::memory_order_release);
+        sendChangeMessage();
+    }
+
+    void PresetIndex::setEntries(std::vector<Entry> newEntries)
+    {
+        entries = std::move(newEntries);
+        names.clearQuick();
+        names.ensureStorageAllocated(static_cast<int>(entries.size()));
+        for (auto& e : entries)
+            names.add(e.info.name);
+    }
+}
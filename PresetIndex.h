@@ -0,0 +1,86 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "MorphWeights.h"
+
+namespace Service
+{
+    //==============================================================================
+    // Sorted, in-memory list of the factory presets and the presets in a directory, shared by every
+    // plugin instance through a juce::SharedResourcePointer. The factory bank is listed straight
+    // away, from memory. The directory is scanned once on a background thread;
+    // after that the thread polls the directory's own modification time, which changes whenever a
+    // file is added, removed or renamed, and only rescans and diffs the entries when it moves. That
+    // keeps a network-mounted library of thousands of presets off the message thread: browsing
+    // reads the index and never touches the disk. A user preset with a factory preset's name
+    // takes its place in the list. A change message is sent whenever the list changes.
+    class PresetIndex : public juce::ChangeBroadcaster,
+                        private juce::Thread
+    {
+    public:
+        static constexpr int pollIntervalMs = 2000;
+
+        // What the browser searches on, read from each preset when it is indexed.
+        struct PresetInfo
+        {
+            juce::String name;
+            bool factory = false;
+            juce::StringArray tags;   // the preset's comma-separated "tags" property
+            std::array<int, JackDistortion::numCorners> corners { -1, -1, -1, -1 };   // algorithm index, -1 if unknown
+        };
+
+        PresetIndex();
+        explicit PresetIndex(const juce::File& directoryToWatch);
+        ~PresetIndex() override;
+
+        /** True once the first scan has finished. */
+        bool isBuilt() const noexcept { return built.load(std::memory_order_acquire); }
+
+        /** Preset names, sorted in natural order. */
+        juce::StringArray getPresetNames() const;
+        int getNumPresets() const;
+        juce::String getPresetName(int index) const;   // empty if out of range
+
+        /** Every preset with its search details, in the same order as getPresetNames(). */
+        std::vector<PresetInfo> getPresetInfos() const;
+        int indexOf(const juce::String& presetName) const;
+
+        /** True if this name is served by the factory bank rather than a file. */
+        bool isFactoryPreset(const juce::String& presetName) const;
+
+        /** Updates the index straight away after this process writes or deletes a preset, rather
+            than on the next poll. */
+        void presetSaved(const juce::String& presetName, const void* data, size_t sizeInBytes);
+        void presetDeleted(const juce::String& presetName);
+
+        /** Rescans on the next poll even if the directory looks unchanged. */
+        void requestRescan();
+
+    private:
+        struct Entry
+        {
+            PresetInfo info;
+            juce::Time modified;
+        };
+
+        static Entry makeEntry(const juce::String& name, juce::Time modified, bool factory, const void* data, size_t sizeInBytes);
+
+        std::vector<Entry>::iterator findEntry(const juce::String& presetName);
+        std::vector<Entry>::const_iterator findEntry(const juce::String& presetName) const;
+        void setEntries(std::vector<Entry> newEntries);
+
+        void run() override;
+        void rescan();
+        void publish(std::vector<Entry> newEntries);
+
+        const juce::File directory;
+        juce::Time lastDirectoryTime;
+        std::atomic<bool> built { false }, rescanRequested { false };
+
+        juce::CriticalSection lock;
+        std::vector<Entry> entries;   // sorted by name
+        juce::StringArray names;      // the same order, for the GUI
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PresetIndex)
+    };
+}
@@ -1,4 +1,5 @@
 #include "PresetManager.h"
+#include "FactoryPresets.h"
 
 namespace Service
 {
@@ -8,22 +9,44 @@ namespace Service
     };
     const juce::String PresetManager::extension { "preset" };
     const juce::String PresetManager::presetNameProperty { "presetName" };
+    const juce::StringArray PresetManager::sessionParameters { "Quality", "RenderQuality", "AdaptiveQuality" };
 
     PresetManager::PresetManager(juce::AudioProcessorValueTreeState& apvts)
-        : valueTreeState(apvts)
+        : valueTreeState(apvts), stateFormat(apvts), parameters(stateFormat.getParameters())
     {
-        if (!defaultDirectory.exists())
+        // The preset directory is only created when the first preset is saved, and the index and
+        // the loading thread when something first asks for them, so a host scanning or restoring
+        // hundreds of instances never waits on the disk or starts a thread per instance.
+        apvts.state.addListener(this);
+        currentPreset.referTo(apvts.state.getPropertyAsValue(presetNameProperty, nullptr));
+
+        pendingValues.resize(parameters.size());
+        for (size_t i = 0; i < parameters.size(); ++i)
         {
-            auto result = defaultDirectory.createDirectory();
-            if (result.failed())
-            {
-                DBG("Could not create preset directory: " + result.getErrorMessage());
-                jassertfalse;
-            }
+            rawValues.push_back(apvts.getRawParameterValue(parameters[i]->getParameterID()));
+            if (!sessionParameters.contains(parameters[i]->getParameterID()))
+                presetParameters.push_back(i);
         }
+    }
 
-        apvts.state.addListener(this);
-        currentPreset.referTo(apvts.state.getPropertyAsValue(presetNameProperty, nullptr));
+    PresetManager::~PresetManager()
+    {
+        // The pool goes first and waits for a read in flight, which writes loadedPreset under
+        // loadLock and triggers an update that is cancelled below.
+        stopTimer();
+        if (loadPool != nullptr)
+            loadPool->removeAllJobs(true, 2000);
+        loadPool.reset();
+        cancelPendingUpdate();
+        valueTreeState.state.removeListener(this);
+    }
+
+    PresetIndex& PresetManager::getPresetIndex() const
+    {
+        if (!presetIndex.has_value())
+            presetIndex.emplace();
+
+        return **presetIndex;
     }
 
     void PresetManager::savePreset(const juce::String& presetName)
@@ -31,15 +54,31 @@ namespace Service
         if (presetName.isEmpty())
             return;
 
+        if (!defaultDirectory.isDirectory())
+        {
+            auto result = defaultDirectory.createDirectory();
+            if (result.failed())
+            {
+                DBG("Could not create preset directory: " + result.getErrorMessage());
+                jassertfalse;
+                return;
+            }
+        }
+
         currentPreset.setValue(presetName);
 
-        auto xml = valueTreeState.copyState().createXml();
+        juce::MemoryBlock data;
+        stateFormat.write(data);
+
         auto presetFile = defaultDirectory.getChildFile(presetName + "." + extension);
-        if (!xml->writeTo(presetFile))
+        if (!presetFile.replaceWithData(data.getData(), data.getSize()))
         {
             DBG("Could not create preset file: " + presetFile.getFullPathName());
             jassertfalse;
+            return;
         }
+
+        getPresetIndex().presetSaved(presetName, data.getData(), data.getSize());
     }
 
     void PresetManager::deletePreset(const juce::String& presetName)
@@ -47,6 +86,12 @@ namespace Service
         if (presetName.isEmpty())
             return;
 
+        if (getPresetIndex().isFactoryPreset(presetName))
+        {
+            DBG("Factory preset " + presetName + " cannot be deleted");
+            return;
+        }
+
         auto presetFile = defaultDirectory.getChildFile(presetName + "." + extension);
         if (!presetFile.existsAsFile())
         {
@@ -62,6 +107,7 @@ namespace Service
             return;
         }
 
+        getPresetIndex().presetDeleted(presetName);
         currentPreset = "";
     }
 
@@ -70,56 +116,212 @@ namespace Service
         if (presetName.isEmpty())
             return;
 
+        // Factory presets are read from the bytes embedded in the plugin; user presets from
+        // their file, on the worker, so a slow disk never holds up the message thread.
+        const auto* factoryPreset = getPresetIndex().isFactoryPreset(presetName) ? findFactoryPreset(presetName) : nullptr;
         auto presetFile = defaultDirectory.getChildFile(presetName + "." + extension);
-        if (!presetFile.existsAsFile())
+
+        // Only the newest request is applied; older ones still parsing are dropped when they finish.
+        requestedPreset = presetName;
+        const int generation = ++loadGeneration;
+
+        if (loadPool == nullptr)
+            loadPool = std::make_unique<juce::ThreadPool>(1);
+
+        loadPool->addJob([this, presetName, presetFile, factoryPreset, generation]
         {
-            DBG("Preset file " + presetFile.getFullPathName() + " does not exist");
+            if (generation != loadGeneration.load())
+                return;
+
+            auto preset = factoryPreset != nullptr
+                        ? readPreset(presetName, factoryPreset->data, factoryPreset->size, stateFormat, generation)
+                        : readPreset(presetFile, stateFormat, generation);
+            {
+                const juce::ScopedLock sl(loadLock);
+                loadedPreset = std::move(preset);
+            }
+            triggerAsyncUpdate();
+        });
+    }
+
+    PresetManager::LoadedPreset PresetManager::readPreset(const juce::File& presetFile, const StateFormat& format, int generation)
+    {
+        juce::MemoryBlock data;
+        if (!presetFile.loadFileAsData(data))
+        {
+            LoadedPreset preset;
+            preset.generation = generation;
+            preset.name = presetFile.getFileNameWithoutExtension();
+            preset.error = "could not be read from " + presetFile.getFullPathName();
+            return preset;
+        }
+
+        return readPreset(presetFile.getFileNameWithoutExtension(), data.getData(), data.getSize(), format, generation);
+    }
+
+    PresetManager::LoadedPreset PresetManager::readPreset(const juce::String& presetName, const void* data, size_t size,
+                                                          const StateFormat& format, int generation)
+    {
+        LoadedPreset preset;
+        preset.generation = generation;
+        preset.name = presetName;
+
+        // Binary presets and the XML ones saved before them both go through the state format.
+        StateFormat::Snapshot snapshot;
+        if (!format.read(data, size, snapshot, &preset.error))
+            return preset;
+
+        preset.properties = std::move(snapshot.properties);
+        preset.values = format.getNormalisedValues(snapshot);
+        preset.extensions = std::move(snapshot.extensions);
+        return preset;
+    }
+
+    void PresetManager::handleAsyncUpdate()
+    {
+        std::optional<LoadedPreset> preset;
+        {
+            const juce::ScopedLock sl(loadLock);
+            preset.swap(loadedPreset);
+        }
+
+        if (!preset.has_value() || preset->generation != loadGeneration.load())
+            return;
+
+        if (preset->error.isNotEmpty())
+        {
+            DBG("Preset " + preset->name + " " + preset->error);
             jassertfalse;
+            requestedPreset = {};
             return;
         }
 
-        juce::XmlDocument xmlDocument { presetFile };
-        auto valueTreeToLoad = juce::ValueTree::fromXml(*xmlDocument.getDocumentElement());
+        readyPreset = std::move(preset);
+        timerCallback();
+    }
+
+    void PresetManager::timerCallback()
+    {
+        if (postedPreset.has_value())
+        {
+            // No block has come for the values, so finishLoad() sets the parameters the usual way,
+            // as any change from this thread would, instead of writing the raw values under a
+            // block. The preset is claimed first and handed back if a block has started by then.
+            if (swapState.load() == swapPending && juce::Time::getMillisecondCounter() - postedAtMs > applyTimeoutMs
+                && !audioBlockRunning.load())
+            {
+                int expected = swapPending;
+                if (swapState.compare_exchange_strong(expected, swapApplying))
+                    swapState.store(audioBlockRunning.load() ? swapPending : swapIdle);
+            }
+
+            if (swapState.load() == swapIdle)
+                finishLoad();
+        }
+
+        if (readyPreset.has_value())
+            postReadyPreset();
+
+        if (readyPreset.has_value() || postedPreset.has_value())
+        {
+            if (!isTimerRunning())
+                startTimer(pollIntervalMs);
+        }
+        else
+        {
+            stopTimer();
+        }
+    }
+
+    bool PresetManager::postReadyPreset()
+    {
+        // Take the values over, or take back a preset no block has picked up yet. If the audio
+        // thread is applying one right now, try again on the next tick.
+        int expected = swapIdle;
+        if (!swapState.compare_exchange_strong(expected, swapApplying))
+        {
+            expected = swapPending;
+            if (!swapState.compare_exchange_strong(expected, swapApplying))
+                return false;
+        }
+
+        std::copy(readyPreset->values.begin(), readyPreset->values.end(), pendingValues.begin());
+        postedPreset = std::move(readyPreset);
+        readyPreset.reset();
+        postedAtMs = juce::Time::getMillisecondCounter();
+        swapState.store(swapPending);
+        return true;
+    }
+
+    void PresetManager::applyPendingPreset() noexcept
+    {
+        audioBlockRunning.store(true);
+
+        int expected = swapPending;
+        if (!swapState.compare_exchange_strong(expected, swapApplying))
+            return;
+
+        applyParameterValues();
+        swapState.store(swapIdle);
+    }
+
+    void PresetManager::applyParameterValues() noexcept
+    {
+        // Only the values the DSP reads change here. Setting the parameters themselves would call
+        // the host and every listener and attachment from this thread; finishLoad() does that.
+        for (auto i : presetParameters)
+            rawValues[i]->store(parameters[i]->convertFrom0to1(pendingValues[i]));
+    }
+
+    void PresetManager::finishLoad()
+    {
+        // The DSP already runs with the new values, unless no block came for them, in which case
+        // this sets them; the host, the listeners, the state's own properties, the preset name
+        // among them, and its extension chunks catch up here on the message thread. Unchanged
+        // parameters are skipped so their listeners and attachments stay quiet.
+        const auto& values = postedPreset->values;
+        for (auto i : presetParameters)
+            if (parameters[i]->getValue() != values[i])
+                parameters[i]->setValueNotifyingHost(values[i]);
+
+        stateFormat.applyProperties(postedPreset->properties);
+        stateFormat.applyExtensions(postedPreset->extensions);
 
-        valueTreeState.replaceState(valueTreeToLoad);
+        postedPreset.reset();
+        if (!readyPreset.has_value())
+            requestedPreset = {};
 
-        // ✅ Properly rebind to the new tree after loading
-        currentPreset.referTo(valueTreeState.state.getPropertyAsValue(presetNameProperty, nullptr));
+        sendChangeMessage();
     }
 
     int PresetManager::loadNextPreset()
     {
-        auto allPresets = getAllPresets();
-        if (allPresets.isEmpty())
+        const int numPresets = getPresetIndex().getNumPresets();
+        if (numPresets == 0)
             return -1;
 
-        int currentIndex = allPresets.indexOf(currentPreset.toString());
-        int nextIndex = (currentIndex + 1 > (allPresets.size() - 1)) ? 0 : currentIndex + 1;
-        loadPreset(allPresets.getReference(nextIndex));
+        int currentIndex = getPresetIndex().indexOf(requestedPreset.isNotEmpty() ? requestedPreset : currentPreset.toString());
+        int nextIndex = (currentIndex + 1 > (numPresets - 1)) ? 0 : currentIndex + 1;
+        loadPreset(getPresetIndex().getPresetName(nextIndex));
         return nextIndex;
     }
 
     int PresetManager::loadPreviousPreset()
     {
-        auto allPresets = getAllPresets();
-        if (allPresets.isEmpty())
+        const int numPresets = getPresetIndex().getNumPresets();
+        if (numPresets == 0)
             return -1;
 
-        int currentIndex = allPresets.indexOf(currentPreset.toString());
-        int previousIndex = (currentIndex - 1 < 0) ? allPresets.size() - 1 : currentIndex - 1;
-        loadPreset(allPresets.getReference(previousIndex));
+        int currentIndex = getPresetIndex().indexOf(requestedPreset.isNotEmpty() ? requestedPreset : currentPreset.toString());
+        int previousIndex = (currentIndex - 1 < 0) ? numPresets - 1 : currentIndex - 1;
+        loadPreset(getPresetIndex().getPresetName(previousIndex));
         return previousIndex;
     }
 
     juce::StringArray PresetManager::getAllPresets() const
     {
-        juce::StringArray presets;
-        auto fileArray = defaultDirectory.findChildFiles(juce::File::findFiles, false, "*." + extension);
-        for (auto& file : fileArray)
-        {
-            presets.add(file.getFileNameWithoutExtension());
-        }
-        return presets;
+        // Served from the in-memory index; empty until its first background scan has finished.
+        return getPresetIndex().getPresetNames();
     }
 
     juce::String PresetManager::getCurrentPreset() const
@@ -1,30 +1,107 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <optional>
+#include "PresetIndex.h"
+#include "StateFormat.h"
 
 namespace Service
 {
-    class PresetManager : public ValueTree::Listener
+    class PresetManager : public ValueTree::Listener,
+                          public juce::ChangeBroadcaster,
+                          private juce::AsyncUpdater,
+                          private juce::Timer
     {
     public:
         static const File defaultDirectory;
         static const String extension;
         static const String presetNameProperty;
-        
+
+        /** Parameters a preset load leaves alone: the quality setup belongs to the machine and
+            the session, not to a sound, so browsing presets never changes it. */
+        static const StringArray sessionParameters;
+
         PresetManager(juce::AudioProcessorValueTreeState& apvts);
+        ~PresetManager() override;
 
         void savePreset(const String& presetName);
         void deletePreset(const String& presetName);
+
+        /** Starts loading a preset and returns straight away. The file is read and checked on a
+            worker thread, and every parameter but the sessionParameters then changes at the start
+            of the same audio block.
+            A change message is sent once the preset is in place. */
         void loadPreset(const String& presetName);
         int loadNextPreset();
         int loadPreviousPreset();
         StringArray getAllPresets() const;
         String getCurrentPreset() const;
-        
+
+        /** The shared index behind getAllPresets(); listen to it to refresh preset lists. The
+            index is only created, and its directory scan started, the first time this is called. */
+        PresetIndex& getPresetIndex() const;
+
+        /** Audio thread, first thing in processBlock: writes a loaded preset's values into the raw
+            parameter values the DSP reads, in one go, before the block reads any of them. The
+            host and listeners are told afterwards, from the message thread. Never blocks or
+            allocates. */
+        void applyPendingPreset() noexcept;
+
+        /** Audio thread, last thing in processBlock, however it returns. Until then the message
+            thread leaves a posted preset for the block to take. */
+        void audioBlockFinished() noexcept  { audioBlockRunning.store(false); }
+
     private:
+        // A preset read and checked off the message thread.
+        struct LoadedPreset
+        {
+            int generation = 0;
+            String name, error;
+            NamedValueSet properties;   // the state's own properties, e.g. the preset name
+            std::vector<float> values;  // normalised, in the processor's parameter order
+            std::vector<StateFormat::Chunk> extensions;  // kept and saved again, see StateFormat
+        };
+
+        // How the parameter hand-off to the audio thread stands. Whichever side moves it from
+        // pending to applying owns pendingValues until it sets it back to idle.
+        enum SwapState { swapIdle = 0, swapPending, swapApplying };
+
+        // If no block has taken a posted preset by then, processBlock is not being called and the
+        // message thread sets the parameters itself, provided no block is running at that moment.
+        static constexpr int applyTimeoutMs = 500;
+        static constexpr int pollIntervalMs = 10;
+
+        static LoadedPreset readPreset(const File& presetFile, const StateFormat& format, int generation);
+        static LoadedPreset readPreset(const String& presetName, const void* data, size_t size,
+                                       const StateFormat& format, int generation);
+
         void valueTreeRedirected(juce::ValueTree& treeWhichHasBeenChanged) override;
+        void handleAsyncUpdate() override;
+        void timerCallback() override;
+        bool postReadyPreset();
+        void applyParameterValues() noexcept;
+        void finishLoad();
 
         AudioProcessorValueTreeState& valueTreeState;
         Value currentPreset;
+        mutable std::optional<juce::SharedResourcePointer<PresetIndex>> presetIndex;   // see getPresetIndex()
+
+        const StateFormat stateFormat;
+        const std::vector<RangedAudioParameter*>& parameters;
+        std::vector<float> pendingValues;
+        std::vector<std::atomic<float>*> rawValues;   // what the DSP reads, in the same order
+        std::vector<size_t> presetParameters;         // indices of the ones a preset sets
+        std::atomic<int> swapState { swapIdle };
+        std::atomic<bool> audioBlockRunning { false };
+
+        std::atomic<int> loadGeneration { 0 };
+        juce::CriticalSection loadLock;
+        std::optional<LoadedPreset> loadedPreset;   // from the worker, under loadLock
+        std::unique_ptr<juce::ThreadPool> loadPool; // created by the first loadPreset(); after what its jobs use
+
+        // Message thread only.
+        String requestedPreset;
+        std::optional<LoadedPreset> readyPreset, postedPreset;
+        juce::uint32 postedAtMs = 0;
     };
 }
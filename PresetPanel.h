@@ -2,16 +2,17 @@
 
 #include <JuceHeader.h>
 #include "graphics.h"
+#include "PresetBrowser.h"
 
 namespace Gui
 {
 
 class PresetPanel : public juce::Component,
                     private juce::Button::Listener,
-                    private juce::ComboBox::Listener
+                    private juce::ChangeListener
 {
 public:
-    PresetPanel(Service::PresetManager& pm) : presetManager(pm)
+    PresetPanel(Service::PresetManager& pm, Service::PreviewPlayer& player) : presetManager(pm), previewPlayer(player)
     {
         presetList.setLookAndFeel(&comboBoxLookAndFeel);
 
@@ -21,10 +22,14 @@ public:
         configureButton(nextPresetButton, ">");
 
         presetList.setTextWhenNothingSelected("- No Preset -");
+        presetList.onShowPopup = [this] { showBrowser(); };
         addAndMakeVisible(presetList);
-        presetList.addListener(this);
 
-        loadPresetList();
+        // The index scans in the background and reports every change to the preset directory;
+        // the manager reports each preset it has finished loading.
+        presetManager.getPresetIndex().addChangeListener(this);
+        presetManager.addChangeListener(this);
+        showCurrentPreset();
     }
     
     ~PresetPanel() override
@@ -33,9 +38,11 @@ public:
         deleteButton.removeListener(this);
         previousPresetButton.removeListener(this);
         nextPresetButton.removeListener(this);
-        presetList.removeListener(this);
+        presetManager.getPresetIndex().removeChangeListener(this);
+        presetManager.removeChangeListener(this);
 
         presetList.setLookAndFeel(nullptr);
+        delete browser.getComponent();
     }
     
     void resetLookAndFeel()
@@ -57,6 +64,25 @@ public:
     }
 
 private:
+    // Shows the current preset like a combo box, but opens the preset browser instead of a popup
+    // menu, which would have to build an item for every preset in the library.
+    struct BrowserComboBox : public juce::ComboBox
+    {
+        std::function<void()> onShowPopup;
+
+        void showPopup() override
+        {
+            if (onShowPopup != nullptr)
+                onShowPopup();
+        }
+
+        void mouseDown(const juce::MouseEvent&) override
+        {
+            if (isEnabled())
+                showPopup();
+        }
+    };
+
     void buttonClicked(juce::Button* button) override
     {
         if (button == &saveButton)
@@ -72,40 +98,44 @@ private:
                 {
                     auto resultFile = chooser.getResult();
                     presetManager.savePreset(resultFile.getFileNameWithoutExtension());
-                    loadPresetList();
                 });
         }
         else if (button == &previousPresetButton)
         {
             int index = presetManager.loadPreviousPreset();
-            presetList.setSelectedItemIndex(index, juce::dontSendNotification);
+            presetList.setText(presetManager.getPresetIndex().getPresetName(index), juce::dontSendNotification);
         }
         else if (button == &nextPresetButton)
         {
             int index = presetManager.loadNextPreset();
-            presetList.setSelectedItemIndex(index, juce::dontSendNotification);
+            presetList.setText(presetManager.getPresetIndex().getPresetName(index), juce::dontSendNotification);
         }
         else if (button == &deleteButton)
         {
             presetManager.deletePreset(presetManager.getCurrentPreset());
-            loadPresetList();
         }
     }
     
-    void comboBoxChanged(juce::ComboBox* comboBoxThatHasChanged) override
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override
     {
-        if (comboBoxThatHasChanged == &presetList)
+        if (source == &presetManager)
+            presetLoaded();
+        else
+            showCurrentPreset();
+    }
+    
+    // Loading finishes asynchronously, so the rest of the UI catches up here rather than on click.
+    void presetLoaded()
+    {
+        showCurrentPreset();
+        
+        if (auto* parent = getParentComponent())
         {
-            presetManager.loadPreset(presetList.getItemText(presetList.getSelectedItemIndex()));
-            
-            if (auto* parent = getParentComponent())
+            parent->repaint(); // repaint full UI
+            for (auto* child : parent->getChildren())
             {
-                parent->repaint(); // repaint full UI
-                for (auto* child : parent->getChildren())
-                {
-                    if (auto* lfoContainer = dynamic_cast<LFOContainer*>(child))
-                        lfoContainer->syncBypassState();
-                }
+                if (auto* lfoContainer = dynamic_cast<LFOContainer*>(child))
+                    lfoContainer->syncBypassState();
             }
         }
     }
@@ -122,18 +152,32 @@ private:
         button.addListener(this);
     }
     
-    void loadPresetList()
+    void showCurrentPreset()
     {
-        presetList.clear(juce::dontSendNotification);
-        auto allPresets = presetManager.getAllPresets();
         auto currentPreset = presetManager.getCurrentPreset();
-        presetList.addItemList(allPresets, 1);
-        presetList.setSelectedItemIndex(allPresets.indexOf(currentPreset), juce::dontSendNotification);
+        if (presetManager.getPresetIndex().indexOf(currentPreset) < 0)
+            currentPreset = {};
+
+        presetList.setText(currentPreset, juce::dontSendNotification);
+    }
+    
+    void showBrowser()
+    {
+        auto* editor = getTopLevelComponent();
+        if (browser != nullptr || editor == nullptr)
+            return;
+
+        // Inside the editor rather than on the desktop, which some hosts do not allow.
+        browser = &juce::CallOutBox::launchAsynchronously(std::make_unique<PresetBrowser>(presetManager, previewPlayer),
+                                                          editor->getLocalArea(&presetList, presetList.getLocalBounds()),
+                                                          editor);
     }
     
     Service::PresetManager& presetManager;
+    Service::PreviewPlayer& previewPlayer;
     juce::TextButton saveButton, deleteButton, previousPresetButton, nextPresetButton;
-    juce::ComboBox presetList;
+    BrowserComboBox presetList;
+    juce::Component::SafePointer<juce::CallOutBox> browser;
     
     std::unique_ptr<juce::FileChooser> fileChooser;
     
@@ -0,0 +1,462 @@
+#include "PresetPreviews.h"
+#include "PresetManager.h"
+#include "FactoryPresets.h"
+#include "PluginProcessor.h"
+#include <optional>
+
+namespace Service
+{
+    namespace
+    {
+        // One bar of kick, bass and hats at 120 bpm: enough low end, transients and sustain to
+        // hear how a preset treats each. Built from a fixed seed, so every render gets the same loop.
+        juce::AudioBuffer<float> makeReferenceLoop(double sampleRate)
+        {
+            constexpr double bpm = 120.0;
+            constexpr int stepsPerBar = 16;
+            const int stepLength = juce::roundToInt(sampleRate * 60.0 / bpm / 4.0);
+            const int length = stepLength * stepsPerBar;
+
+            juce::AudioBuffer<float> loop(2, length);
+            loop.clear();
+            auto* left = loop.getWritePointer(0);
+            auto* right = loop.getWritePointer(1);
+
+            const auto seconds = [sampleRate](int sample) { return static_cast<float>(sample / sampleRate); };
+            constexpr float twoPi = juce::MathConstants<float>::twoPi;
+
+            // Kick on every beat: a falling sine.
+            for (int step = 0; step < stepsPerBar; step += 4)
+            {
+                float phase = 0.0f;
+                for (int i = 0; i < stepLength * 2 && step * stepLength + i < length; ++i)
+                {
+                    const float t = seconds(i);
+                    phase += twoPi * (45.0f + 75.0f * std::exp(-t * 30.0f)) / static_cast<float>(sampleRate);
+                    const float sample = 0.6f * std::sin(phase) * std::exp(-t * 9.0f);
+                    left[step * stepLength + i] += sample;
+                    right[step * stepLength + i] += sample;
+                }
+            }
+
+            // Bass on the eighths, a plucked and lightly filtered saw.
+            constexpr std::array<float, 8> bassNotes { 55.0f, 55.0f, 110.0f, 55.0f, 82.41f, 55.0f, 98.0f, 73.42f };
+            for (int note = 0; note < 8; ++note)
+            {
+                float phase = 0.0f, filtered = 0.0f;
+                const int start = note * 2 * stepLength;
+                for (int i = 0; i < stepLength * 2 && start + i < length; ++i)
+                {
+                    phase += bassNotes[static_cast<size_t>(note)] / static_cast<float>(sampleRate);
+                    phase -= std::floor(phase);
+                    filtered += 0.15f * ((2.0f * phase - 1.0f) - filtered);
+                    const float sample = 0.35f * filtered * std::exp(-seconds(i) * 4.0f);
+                    left[start + i] += sample;
+                    right[start + i] += sample;
+                }
+            }
+
+            // Hats on the off-beat eighths, noise with a short decay, slightly off centre.
+            juce::Random random(0x4f58);
+            for (int step = 2; step < stepsPerBar; step += 4)
+            {
+                float previous = 0.0f;
+                for (int i = 0; i < stepLength && step * stepLength + i < length; ++i)
+                {
+                    const float noise = random.nextFloat() * 2.0f - 1.0f;
+                    const float sample = 0.12f * (noise - previous) * std::exp(-seconds(i) * 60.0f);
+                    previous = noise;
+                    left[step * stepLength + i] += sample * 0.8f;
+                    right[step * stepLength + i] += sample;
+                }
+            }
+
+            return loop;
+        }
+    }
+
+    const juce::File PresetPreviews::cacheDirectory { juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile(ProjectInfo::companyName)
+        .getChildFile(ProjectInfo::projectName)
+        .getChildFile("Previews")
+    };
+
+    PresetPreviews::PresetPreviews()
+        : juce::Thread("Preset previews")
+    {
+        presetIndex->addChangeListener(this);
+        startThread(juce::Thread::Priority::low);
+    }
+
+    PresetPreviews::~PresetPreviews()
+    {
+        presetIndex->removeChangeListener(this);
+        stopThread(4000);
+    }
+
+    PresetPreviews::PreviewPtr PresetPreviews::getPreview(const juce::String& presetName, double sampleRate)
+    {
+        if (presetName.isEmpty() || sampleRate <= 0.0)
+            return nullptr;
+
+        {
+            const juce::ScopedLock sl(lock);
+            auto known = keysByName.find(presetName + "@" + juce::String(sampleRate));
+            if (known != keysByName.end())
+                if (auto preview = findInMemory(known->second))
+                    return preview;
+
+            queue.erase(std::remove_if(queue.begin(), queue.end(),
+                                       [&](const Request& r) { return r.presetName == presetName && r.sampleRate == sampleRate; }),
+                        queue.end());
+            queue.push_front({ presetName, sampleRate });
+            if (queue.size() > static_cast<size_t>(maxQueuedRequests))
+                queue.pop_back();
+        }
+
+        notify();
+        return nullptr;
+    }
+
+    void PresetPreviews::changeListenerCallback(juce::ChangeBroadcaster*)
+    {
+        // A preset may have been saved over; the next request hashes its bytes again.
+        const juce::ScopedLock sl(lock);
+        keysByName.clear();
+    }
+
+    void PresetPreviews::run()
+    {
+        pruneDisk();
+
+        while (! threadShouldExit())
+        {
+            std::optional<Request> request;
+            {
+                const juce::ScopedLock sl(lock);
+                if (! queue.empty())
+                {
+                    request = queue.front();
+                    queue.pop_front();
+                }
+            }
+
+            if (request.has_value())
+                process(*request);
+            else
+                wait(-1);
+        }
+    }
+
+    void PresetPreviews::process(const Request& request)
+    {
+        juce::MemoryBlock fileData;
+        const void* data = nullptr;
+        size_t size = 0;
+
+        if (const auto* factoryPreset = presetIndex->isFactoryPreset(request.presetName) ? findFactoryPreset(request.presetName) : nullptr)
+        {
+            data = factoryPreset->data;
+            size = factoryPreset->size;
+        }
+        else if (PresetManager::defaultDirectory.getChildFile(request.presetName + "." + PresetManager::extension).loadFileAsData(fileData))
+        {
+            data = fileData.getData();
+            size = fileData.getSize();
+        }
+        else
+        {
+            DBG("No preset to preview: " + request.presetName);
+            return;
+        }
+
+        const auto key = getKey(data, size, request.sampleRate);
+        const auto cacheFile = getCacheFile(key);
+
+        PreviewPtr preview;
+        {
+            const juce::ScopedLock sl(lock);
+            preview = findInMemory(key);
+        }
+
+        if (preview == nullptr && cacheFile.existsAsFile())
+        {
+            preview = readFromDisk(cacheFile);
+            if (preview != nullptr && preview->sampleRate != request.sampleRate)
+                preview = nullptr;
+        }
+
+        if (preview == nullptr)
+        {
+            preview = render(data, size, request.sampleRate);
+            if (preview == nullptr)
+                return;
+
+            writeToDisk(cacheFile, *preview);
+        }
+
+        {
+            const juce::ScopedLock sl(lock);
+            keysByName[request.presetName + "@" + juce::String(request.sampleRate)] = key;
+            addToMemory(key, std::move(preview));
+        }
+
+        sendChangeMessage();
+    }
+
+    PresetPreviews::PreviewPtr PresetPreviews::render(const void* data, size_t sizeInBytes, double sampleRate)
+    {
+        if (processor == nullptr)
+            processor = std::make_unique<OrbitXAudioProcessor>();
+
+        StateFormat::Snapshot snapshot;
+        juce::String error;
+        if (! processor->stateFormat.read(data, sizeInBytes, snapshot, &error))
+        {
+            DBG("Could not preview preset: " + error);
+            return nullptr;
+        }
+
+        // Only the parameters are set: the private processor's state properties never matter.
+        const auto& parameters = processor->stateFormat.getParameters();
+        const auto values = processor->stateFormat.getNormalisedValues(snapshot);
+        for (size_t i = 0; i < parameters.size(); ++i)
+            parameters[i]->setValueNotifyingHost(values[i]);
+
+        processor->setNonRealtime(true);
+        processor->setRateAndBufferSizeDetails(sampleRate, renderBlockSize);
+        processor->prepareToPlay(sampleRate, renderBlockSize);
+        processor->reset();
+
+        const auto& loop = getReferenceLoop(sampleRate);
+        const int length = loop.getNumSamples();
+        const int latency = processor->getLatencySamples();
+
+        auto preview = std::make_shared<Preview>();
+        preview->sampleRate = sampleRate;
+        preview->audio.setSize(loop.getNumChannels(), length);
+
+        // The first latency samples are dropped and the same amount of silence flushed at the end.
+        juce::AudioBuffer<float> block(loop.getNumChannels(), renderBlockSize);
+        juce::MidiBuffer midi;
+        for (int rendered = 0; rendered < length + latency; rendered += renderBlockSize)
+        {
+            if (threadShouldExit())
+                return nullptr;
+
+            const int numSamples = juce::jmin(renderBlockSize, length + latency - rendered);
+            block.setSize(block.getNumChannels(), numSamples, false, false, true);
+            block.clear();
+            for (int channel = 0; channel < block.getNumChannels(); ++channel)
+                if (rendered < length)
+                    block.copyFrom(channel, 0, loop, channel, rendered, juce::jmin(numSamples, length - rendered));
+
+            const auto startTicks = juce::Time::getHighResolutionTicks();
+            processor->processBlock(block, midi);
+            const double blockMs = 1000.0 * juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+
+            const int skip = juce::jlimit(0, numSamples, latency - rendered);
+            const int copy = juce::jmin(numSamples - skip, length - juce::jmax(0, rendered - latency));
+            for (int channel = 0; channel < block.getNumChannels() && copy > 0; ++channel)
+                preview->audio.copyFrom(channel, juce::jmax(0, rendered + skip - latency), block, channel, skip, copy);
+
+            wait(juce::jmax(1, juce::roundToInt(blockMs * throttleRatio)));
+        }
+
+        processor->releaseResources();
+        return preview;
+    }
+
+    const juce::AudioBuffer<float>& PresetPreviews::getReferenceLoop(double sampleRate)
+    {
+        if (referenceLoopRate != sampleRate)
+        {
+            referenceLoop = makeReferenceLoop(sampleRate);
+            referenceLoopRate = sampleRate;
+        }
+        return referenceLoop;
+    }
+
+    juce::uint64 PresetPreviews::getKey(const void* data, size_t sizeInBytes, double sampleRate)
+    {
+        // FNV-1a over the preset, then the rate and the render version.
+        juce::uint64 hash = 0xcbf29ce484222325ull;
+        const auto mix = [&hash](const void* bytes, size_t size)
+        {
+            for (size_t i = 0; i < size; ++i)
+            {
+                hash ^= static_cast<const juce::uint8*>(bytes)[i];
+                hash *= 0x100000001b3ull;
+            }
+        };
+
+        mix(data, sizeInBytes);
+        const auto rate = static_cast<juce::int64>(sampleRate);
+        mix(&rate, sizeof(rate));
+        mix(&renderVersion, sizeof(renderVersion));
+        return hash;
+    }
+
+    juce::File PresetPreviews::getCacheFile(juce::uint64 key)
+    {
+        return cacheDirectory.getChildFile(juce::String::toHexString(static_cast<juce::int64>(key)).paddedLeft('0', 16) + ".preview");
+    }
+
+    // File layout: u32 magic, u16 render version, u16 channels, u32 sample rate, u32 samples,
+    // then each channel's samples as 16-bit integers, all little-endian.
+    PresetPreviews::PreviewPtr PresetPreviews::readFromDisk(const juce::File& file)
+    {
+        juce::FileInputStream input(file);
+        if (! input.openedOk()
+            || static_cast<juce::uint32>(input.readInt()) != fileMagic
+            || static_cast<juce::uint16>(input.readShort()) != renderVersion)
+            return nullptr;
+
+        const int numChannels = input.readShort();
+        const int sampleRate = input.readInt();
+        const int numSamples = input.readInt();
+        if (numChannels <= 0 || numChannels > 2 || sampleRate <= 0 || numSamples <= 0
+            || input.getNumBytesRemaining() != static_cast<juce::int64>(numChannels) * numSamples * 2)
+            return nullptr;
+
+        auto preview = std::make_shared<Preview>();
+        preview->sampleRate = sampleRate;
+        preview->audio.setSize(numChannels, numSamples);
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* samples = preview->audio.getWritePointer(channel);
+            for (int i = 0; i < numSamples; ++i)
+                samples[i] = static_cast<float>(input.readShort()) / 32767.0f;
+        }
+
+        // Recently used previews are the last to be pruned.
+        file.setLastModificationTime(juce::Time::getCurrentTime());
+        return preview;
+    }
+
+    void PresetPreviews::writeToDisk(const juce::File& file, const Preview& preview)
+    {
+        if (cacheDirectory.createDirectory().failed())
+            return;
+
+        // Written aside and moved into place, so another instance never reads half a file.
+        juce::TemporaryFile temporary(file);
+        {
+            juce::FileOutputStream output(temporary.getFile());
+            if (! output.openedOk())
+                return;
+
+            output.writeInt(static_cast<int>(fileMagic));
+            output.writeShort(static_cast<short>(renderVersion));
+            output.writeShort(static_cast<short>(preview.audio.getNumChannels()));
+            output.writeInt(juce::roundToInt(preview.sampleRate));
+            output.writeInt(preview.audio.getNumSamples());
+
+            for (int channel = 0; channel < preview.audio.getNumChannels(); ++channel)
+            {
+                const auto* samples = preview.audio.getReadPointer(channel);
+                for (int i = 0; i < preview.audio.getNumSamples(); ++i)
+                    output.writeShort(static_cast<short>(juce::roundToInt(juce::jlimit(-1.0f, 1.0f, samples[i]) * 32767.0f)));
+            }
+        }
+
+        if (! temporary.overwriteTargetFileWithTemporary())
+            DBG("Could not write preview " + file.getFullPathName());
+    }
+
+    void PresetPreviews::pruneDisk()
+    {
+        auto files = cacheDirectory.findChildFiles(juce::File::findFiles, false, "*.preview");
+        if (files.size() <= maxPreviewsOnDisk)
+            return;
+
+        std::sort(files.begin(), files.end(), [](const juce::File& a, const juce::File& b)
+                  { return a.getLastModificationTime() > b.getLastModificationTime(); });
+
+        for (int i = maxPreviewsOnDisk; i < files.size(); ++i)
+            files[i].deleteFile();
+    }
+
+    PresetPreviews::PreviewPtr PresetPreviews::findInMemory(juce::uint64 key)
+    {
+        for (auto& cached : memory)
+        {
+            if (cached.key == key)
+            {
+                cached.lastUsed = ++useCounter;
+                return cached.preview;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void PresetPreviews::addToMemory(juce::uint64 key, PreviewPtr preview)
+    {
+        if (findInMemory(key) != nullptr)
+            return;
+
+        if (memory.size() >= static_cast<size_t>(maxPreviewsInMemory))
+        {
+            auto oldest = std::min_element(memory.begin(), memory.end(),
+                                           [](const CachedPreview& a, const CachedPreview& b) { return a.lastUsed < b.lastUsed; });
+            memory.erase(oldest);
+        }
+
+        memory.push_back({ key, std::move(preview), ++useCounter });
+    }
+
+    //==============================================================================
+    void PreviewPlayer::play(PresetPreviews::PreviewPtr preview)
+    {
+        if (preview != nullptr)
+            retained.push_back(preview);
+
+        requested.store(preview.get());
+        ++playCount;
+        playing.store(preview != nullptr);
+
+        // Whatever the audio thread is not reading now, it never will again.
+        const auto* stillRequested = requested.load();
+        const auto* stillInUse = inUse.load();
+        retained.erase(std::remove_if(retained.begin(), retained.end(),
+                                      [&](const PresetPreviews::PreviewPtr& p) { return p.get() != stillRequested && p.get() != stillInUse; }),
+                       retained.end());
+    }
+
+    void PreviewPlayer::process(juce::AudioBuffer<float>& buffer) noexcept
+    {
+        // Publish the preview before reading it; if play() swapped it meanwhile, look again.
+        const PresetPreviews::Preview* preview = nullptr;
+        do
+        {
+            preview = requested.load();
+            inUse.store(preview);
+        }
+        while (preview != requested.load());
+
+        const auto count = playCount.load();
+        if (preview != current || count != currentCount)
+        {
+            current = preview;
+            currentCount = count;
+            position = 0;
+        }
+
+        if (current == nullptr || current->sampleRate != preparedRate.load())
+            return;
+
+        const auto& audio = current->audio;
+        const int numSamples = juce::jmin(buffer.getNumSamples(), audio.getNumSamples() - position);
+        if (numSamples <= 0)
+        {
+            playing.store(false);
+            return;
+        }
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            buffer.addFrom(channel, 0, audio, juce::jmin(channel, audio.getNumChannels() - 1), position, numSamples, gain);
+
+        position += numSamples;
+    }
+}
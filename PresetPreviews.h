@@ -0,0 +1,131 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <deque>
+#include <map>
+#include "PresetIndex.h"
+
+class OrbitXAudioProcessor;
+
+namespace Service
+{
+    //==============================================================================
+    // Short renders of presets over a built-in reference loop, so the browser can play what a
+    // preset sounds like without loading it. Shared by every plugin instance through a
+    // juce::SharedResourcePointer while a browser is open.
+    //
+    // Renders run one at a time on a low-priority thread, through a private processor that
+    // never touches a live instance. After each block the thread sleeps for three times as long
+    // as the block took, so it never uses more than a quarter of a core. Each preview is keyed by
+    // a hash of the preset's bytes and the sample rate. It is kept in memory for this session and
+    // written to a cache folder, so a preset is only rendered again once it changes.
+    class PresetPreviews : public juce::ChangeBroadcaster,
+                           private juce::Thread,
+                           private juce::ChangeListener
+    {
+    public:
+        struct Preview
+        {
+            double sampleRate = 0.0;
+            juce::AudioBuffer<float> audio;
+        };
+        using PreviewPtr = std::shared_ptr<const Preview>;
+
+        static const juce::File cacheDirectory;
+
+        PresetPreviews();
+        ~PresetPreviews() override;
+
+        /** The preview of this preset at this rate if it is ready. Otherwise returns nullptr and
+            queues it; a change message is sent once it has been read from the cache or
+            rendered. Message thread. */
+        PreviewPtr getPreview(const juce::String& presetName, double sampleRate);
+
+    private:
+        static constexpr int renderBlockSize = 512;
+        static constexpr int throttleRatio = 3;           // sleep this many times a block's render time
+        static constexpr int maxQueuedRequests = 8;       // older requests are dropped, newest first
+        static constexpr int maxPreviewsInMemory = 16;
+        static constexpr int maxPreviewsOnDisk = 500;
+        static constexpr juce::uint32 fileMagic = 0x7670584f;   // "OXpv"
+        static constexpr juce::uint16 renderVersion = 1;         // bump when the loop or the engine's sound changes
+
+        struct Request
+        {
+            juce::String presetName;
+            double sampleRate = 0.0;
+        };
+
+        struct CachedPreview
+        {
+            juce::uint64 key = 0;
+            PreviewPtr preview;
+            juce::uint32 lastUsed = 0;
+        };
+
+        void run() override;
+        void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+
+        void process(const Request& request);
+        PreviewPtr render(const void* data, size_t sizeInBytes, double sampleRate);
+        const juce::AudioBuffer<float>& getReferenceLoop(double sampleRate);
+
+        static juce::uint64 getKey(const void* data, size_t sizeInBytes, double sampleRate);
+        static juce::File getCacheFile(juce::uint64 key);
+        static PreviewPtr readFromDisk(const juce::File& file);
+        static void writeToDisk(const juce::File& file, const Preview& preview);
+        static void pruneDisk();
+
+        PreviewPtr findInMemory(juce::uint64 key);
+        void addToMemory(juce::uint64 key, PreviewPtr preview);
+
+        juce::SharedResourcePointer<PresetIndex> presetIndex;
+
+        juce::CriticalSection lock;
+        std::deque<Request> queue;                          // newest first
+        std::vector<CachedPreview> memory;
+        std::map<juce::String, juce::uint64> keysByName;    // "name@rate"; forgotten when the index changes
+        juce::uint32 useCounter = 0;
+
+        // Render thread only.
+        std::unique_ptr<OrbitXAudioProcessor> processor;
+        juce::AudioBuffer<float> referenceLoop;
+        double referenceLoopRate = 0.0;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PresetPreviews)
+    };
+
+    //==============================================================================
+    // Mixes a preview over a processor's output while it plays. play() and stop() are for the
+    // message thread and process() for the audio thread. The audio thread publishes the preview
+    // it is reading before using it, and the message thread only lets go of previews it is no
+    // longer reading, so neither side ever locks or waits.
+    class PreviewPlayer
+    {
+    public:
+        static constexpr float gain = 0.7f;
+
+        /** Called from prepareToPlay; the browser asks for previews at this rate. */
+        void prepare(double sampleRate) noexcept { preparedRate.store(sampleRate); }
+        double getSampleRate() const noexcept    { return preparedRate.load(); }
+
+        void play(PresetPreviews::PreviewPtr preview);
+        void stop()                              { play(nullptr); }
+        bool isPlaying() const noexcept          { return playing.load(); }
+
+        void process(juce::AudioBuffer<float>& buffer) noexcept;
+
+    private:
+        std::atomic<const PresetPreviews::Preview*> requested { nullptr }, inUse { nullptr };
+        std::atomic<juce::uint32> playCount { 0 };
+        std::atomic<bool> playing { false };
+        std::atomic<double> preparedRate { 0.0 };
+
+        std::vector<PresetPreviews::PreviewPtr> retained;   // message thread: all the audio thread may hold
+
+        // Audio thread only.
+        const PresetPreviews::Preview* current = nullptr;
+        juce::uint32 currentCount = 0;
+        int position = 0;
+    };
+}
@@ -0,0 +1,211 @@
+#include "PresetSearch.h"
+#include "distortion.h"
+#include <numeric>
+
+namespace Service
+{
+    namespace
+    {
+        std::string toSearchText(const juce::String& text)
+        {
+            return text.toLowerCase().toStdString();
+        }
+
+        std::vector<std::string> splitWords(const std::string& query)
+        {
+            std::vector<std::string> words;
+            std::string word;
+            for (char c : query)
+            {
+                if (c == ' ' || c == '\t')
+                {
+                    if (! word.empty())
+                        words.push_back(std::move(word));
+                    word.clear();
+                }
+                else
+                {
+                    word += c;
+                }
+            }
+
+            if (! word.empty())
+                words.push_back(std::move(word));
+
+            return words;
+        }
+
+        bool isWordStart(const std::string& text, size_t position)
+        {
+            if (position == 0)
+                return true;
+
+            const char previous = text[position - 1];
+            return previous == ' ' || previous == '-' || previous == '_' || previous == '\n' || previous == '(';
+        }
+
+        bool hasWordStartingWith(const std::string& text, const std::string& word)
+        {
+            for (auto position = text.find(word); position != std::string::npos; position = text.find(word, position + 1))
+                if (isWordStart(text, position))
+                    return true;
+
+            return false;
+        }
+
+        bool containsInOrder(const std::string& text, const std::string& word)
+        {
+            size_t next = 0;
+            for (char c : text)
+                if (next < word.size() && c == word[next])
+                    ++next;
+
+            return next == word.size();
+        }
+    }
+
+    void PresetSearch::setPresets(std::vector<PresetIndex::PresetInfo> newPresets)
+    {
+        presets = std::move(newPresets);
+        searchText.clear();
+        searchText.reserve(presets.size());
+
+        const auto& algorithmNames = JackDistortion::getAlgorithmNames();
+        for (const auto& preset : presets)
+        {
+            // One detail per line, so a word never runs from one detail into the next.
+            juce::String details = preset.factory ? "factory" : "user";
+            for (const auto& tag : preset.tags)
+                details << "\n" << tag;
+            for (int algorithm : preset.corners)
+                if (juce::isPositiveAndBelow(algorithm, algorithmNames.size()))
+                    details << "\n" << algorithmNames[algorithm];
+
+            SearchText text { toSearchText(preset.name), toSearchText(details), 0 };
+            text.characters = getCharacterMask(text.name) | getCharacterMask(text.details);
+            searchText.push_back(std::move(text));
+        }
+
+        history.clear();
+        results.resize(presets.size());
+        std::iota(results.begin(), results.end(), 0);
+    }
+
+    const std::vector<int>& PresetSearch::search(const juce::String& query)
+    {
+        const auto normalised = toSearchText(query.trim());
+        const auto words = splitWords(normalised);
+
+        // Anything that matches a query also matched every query it extends, so start from the
+        // matches of the longest earlier query this one begins with. That covers typing forwards
+        // and deleting back alike, and only the first letter ever looks at every preset.
+        while (! history.empty() && normalised.compare(0, history.back().query.size(), history.back().query) != 0)
+            history.pop_back();
+
+        results.clear();
+        if (words.empty())
+        {
+            results.resize(presets.size());
+            std::iota(results.begin(), results.end(), 0);
+            return results;
+        }
+
+        if (! history.empty() && history.back().query == normalised)
+        {
+            scores.clear();
+            for (int index : history.back().matches)
+                scores.push_back(scoreAll(index, words));
+
+            return rank(history.back().matches, words.size());
+        }
+
+        std::vector<int> matches;
+        scores.clear();
+        auto consider = [&](int index)
+        {
+            const int score = scoreAll(index, words);
+            if (score != noMatch)
+            {
+                matches.push_back(index);
+                scores.push_back(score);
+            }
+        };
+
+        if (history.empty())
+        {
+            for (int index = 0; index < static_cast<int>(presets.size()); ++index)
+                consider(index);
+        }
+        else
+        {
+            for (int index : history.back().matches)
+                consider(index);
+        }
+
+        history.push_back({ normalised, std::move(matches) });
+        return rank(history.back().matches, words.size());
+    }
+
+    int PresetSearch::scoreAll(int index, const std::vector<std::string>& words) const
+    {
+        const auto& text = searchText[static_cast<size_t>(index)];
+        int total = 0;
+        for (const auto& word : words)
+        {
+            const int score = (getCharacterMask(word) & ~text.characters) == 0 ? scoreWord(text, word) : noMatch;
+            if (score == noMatch)
+                return noMatch;
+
+            total += score;
+        }
+
+        return total;
+    }
+
+    const std::vector<int>& PresetSearch::rank(const std::vector<int>& matches, size_t numWords)
+    {
+        // Scores are small whole numbers, so bucket the matches rather than sorting them: that is
+        // linear, and as matches are in index order each bucket keeps the index's name order.
+        bucketStarts.assign(static_cast<size_t>(worstScore) * numWords + 2, 0);
+        for (int score : scores)
+            ++bucketStarts[static_cast<size_t>(score) + 1];
+
+        for (size_t score = 1; score < bucketStarts.size(); ++score)
+            bucketStarts[score] += bucketStarts[score - 1];
+
+        results.resize(matches.size());
+        for (size_t i = 0; i < matches.size(); ++i)
+            results[static_cast<size_t>(bucketStarts[static_cast<size_t>(scores[i])]++)] = matches[i];
+
+        return results;
+    }
+
+    uint64_t PresetSearch::getCharacterMask(const std::string& text) noexcept
+    {
+        uint64_t mask = 0;
+        for (char c : text)
+            mask |= uint64_t { 1 } << (static_cast<unsigned char>(c) & 63);
+
+        return mask;
+    }
+
+    int PresetSearch::scoreWord(const SearchText& text, const std::string& word)
+    {
+        if (text.name.compare(0, word.size(), word) == 0)
+            return 0;
+
+        if (hasWordStartingWith(text.name, word))
+            return 1;
+
+        if (text.name.find(word) != std::string::npos)
+            return 2;
+
+        if (hasWordStartingWith(text.details, word))
+            return 3;
+
+        if (containsInOrder(text.name, word))
+            return worstScore;
+
+        return noMatch;
+    }
+}
@@ -0,0 +1,116 @@
+#include "SharedTables.h"
+
+namespace JackDistortion {
+
+SharedTableCache::~SharedTableCache()
+{
+    if (buildPool != nullptr)
+        buildPool->removeAllJobs(true, 5000);
+}
+
+SharedTablePtr SharedTableCache::request(const TableKey& key, Builder builder)
+{
+    const juce::ScopedLock sl(lock);
+
+    auto& slot = tables[key];
+    if (auto existing = slot.lock())
+        return existing;
+
+    auto table = std::make_shared<SharedTable>();
+    slot = table;
+
+    if (buildPool == nullptr)
+        buildPool = std::make_unique<juce::ThreadPool>(1);
+
+    // The job keeps the table alive until it has been published.
+    buildPool->addJob([table, build = std::move(builder)]
+    {
+        table->values = build();
+        table->ready.store(true, std::memory_order_release);
+    });
+
+    // Drop entries whose tables every instance has released.
+    for (auto it = tables.begin(); it != tables.end();)
+        it = it->second.expired() ? tables.erase(it) : std::next(it);
+
+    return table;
+}
+
+SharedTablePtr SharedTableCache::requestCurve(int algorithm, float drive, int size)
+{
+    jassert(canTabulateCurve(algorithm));
+
+    TableKey key;
+    key.kind = TableKey::Kind::curve;
+    key.curve = algorithm;
+    key.driveStep = quantiseDrive(drive);
+    key.size = size;
+
+    const float quantisedDrive = static_cast<float>(key.driveStep) * 0.1f;
+    return request(key, [algorithm, quantisedDrive, size] { return buildCurveTable(algorithm, quantisedDrive, size); });
+}
+
+SharedTablePtr SharedTableCache::requestMorphWeights(int gridSize)
+{
+    TableKey key;
+    key.kind = TableKey::Kind::morphWeights;
+    key.size = gridSize;
+
+    return request(key, [gridSize] { return buildMorphWeightGrid(gridSize); });
+}
+
+int SharedTableCache::getNumLiveTables() const
+{
+    const juce::ScopedLock sl(lock);
+    return static_cast<int>(std::count_if(tables.begin(), tables.end(),
+                                          [](const auto& entry) { return ! entry.second.expired(); }));
+}
+
+//------------------------------------------------------------------------------------------------------------//
+bool canTabulateCurve(int algorithm)
+{
+    return ! isStateful(algorithm);
+}
+
+int quantiseDrive(float drive)
+{
+    return juce::roundToInt(drive * 10.0f);
+}
+
+std::vector<float> buildCurveTable(int algorithm, float drive, int size)
+{
+    std::vector<float> values(static_cast<size_t>(size));
+    auto distortion = makeDistortion(algorithm);
+
+    std::visit([&](auto& d)
+    {
+        d.setParameters(drive, 0.0f);
+        for (int i = 0; i < size; ++i)
+        {
+            const float x = -SharedTableCache::curveInputRange
+                          + 2.0f * SharedTableCache::curveInputRange * static_cast<float>(i) / static_cast<float>(size - 1);
+            values[static_cast<size_t>(i)] = d.processSample(x);
+        }
+    }, distortion);
+
+    return values;
+}
+
+std::vector<float> buildMorphWeightGrid(int gridSize)
+{
+    std::vector<float> grid(static_cast<size_t>(gridSize * gridSize * numCorners));
+    const float scale = 1.0f / static_cast<float>(gridSize - 1);
+
+    for (int iy = 0; iy < gridSize; ++iy)
+    {
+        for (int ix = 0; ix < gridSize; ++ix)
+        {
+            const auto weights = computeMorphWeights(static_cast<float>(ix) * scale, static_cast<float>(iy) * scale);
+            std::copy(weights.begin(), weights.end(), grid.begin() + (iy * gridSize + ix) * numCorners);
+        }
+    }
+
+    return grid;
+}
+
+} // namespace JackDistortion
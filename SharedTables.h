@@ -0,0 +1,133 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "distortion.h"
+#include "MorphWeights.h"
+
+namespace JackDistortion {
+
+//------------------------------------------------------------------------------------------------------------//
+// Identifies a table by everything its contents depend on.
+struct TableKey
+{
+    enum class Kind { curve, morphWeights };
+
+    Kind kind = Kind::curve;
+    int curve = 0;       // registry index for curve tables
+    int driveStep = 0;   // drive in PostXYDrive steps (0.1 dB)
+    int size = 0;
+
+    bool operator<(const TableKey& other) const
+    {
+        return std::tie(kind, curve, driveStep, size)
+             < std::tie(other.kind, other.curve, other.driveStep, other.size);
+    }
+};
+
+//------------------------------------------------------------------------------------------------------------//
+// An immutable table. It is filled on the cache's build thread and only read once isReady()
+// returns true, so the audio thread can poll it without locking.
+class SharedTable
+{
+public:
+    bool isReady() const noexcept     { return ready.load(std::memory_order_acquire); }
+    const float* data() const noexcept { return values.data(); }
+    int size() const noexcept          { return static_cast<int>(values.size()); }
+
+private:
+    friend class SharedTableCache;
+    std::vector<float> values;
+    std::atomic<bool> ready { false };
+};
+
+using SharedTablePtr = std::shared_ptr<const SharedTable>;
+
+//------------------------------------------------------------------------------------------------------------//
+// Process-wide cache of read-only DSP tables, shared by every plugin instance through a
+// juce::SharedResourcePointer. Each table is reference counted by the instances holding it and
+// freed when the last one lets go. Tables are built lazily on a background thread; call request()
+// from prepareToPlay or the message thread, never from the audio thread.
+class SharedTableCache
+{
+public:
+    static constexpr float curveInputRange = 2.0f;  // curve tables cover +/- 6 dBFS
+    static constexpr int curveTableSize = 4096;
+    static constexpr int morphGridSize = 129;
+
+    SharedTableCache() = default;
+    ~SharedTableCache();
+
+    using Builder = std::function<std::vector<float>()>;
+
+    /** Returns the table for the key, scheduling a build if no instance currently holds it. */
+    SharedTablePtr request(const TableKey& key, Builder builder);
+
+    /** Transfer curve of a stateless algorithm at the given drive. */
+    SharedTablePtr requestCurve(int algorithm, float drive, int size = curveTableSize);
+
+    /** Corner weights over the XY pad, four interleaved values per grid point. */
+    SharedTablePtr requestMorphWeights(int gridSize = morphGridSize);
+
+    int getNumLiveTables() const;
+
+private:
+    juce::CriticalSection lock;
+    std::map<TableKey, std::weak_ptr<SharedTable>> tables;
+    std::unique_ptr<juce::ThreadPool> buildPool;   // started by the first request, not by every instance
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SharedTableCache)
+};
+
+//------------------------------------------------------------------------------------------------------------//
+// Table builders and lookups.
+
+/** Stateful algorithms (lofi) cannot be tabulated. */
+bool canTabulateCurve(int algorithm);
+
+int quantiseDrive(float drive);
+
+std::vector<float> buildCurveTable(int algorithm, float drive, int size);
+
+/** Linear interpolation inside +/- curveInputRange; returns false outside it. */
+inline bool lookupCurve(const float* table, int size, float x, float& result)
+{
+    const float position = (x + SharedTableCache::curveInputRange)
+                         * (static_cast<float>(size - 1) / (2.0f * SharedTableCache::curveInputRange));
+    if (! (position >= 0.0f && position <= static_cast<float>(size - 1)))
+        return false;
+
+    const int index = juce::jmin(static_cast<int>(position), size - 2);
+    const float frac = position - static_cast<float>(index);
+    result = table[index] + frac * (table[index + 1] - table[index]);
+    return true;
+}
+
+std::vector<float> buildMorphWeightGrid(int gridSize);
+
+/** Bilinear lookup of the corner weights for an effective XY position (both 0..1). */
+inline CornerWeights lookupMorphWeights(const float* grid, int gridSize, float x, float y)
+{
+    const float scale = static_cast<float>(gridSize - 1);
+    const float fx = juce::jlimit(0.0f, scale, x * scale);
+    const float fy = juce::jlimit(0.0f, scale, y * scale);
+    const int ix = juce::jmin(static_cast<int>(fx), gridSize - 2);
+    const int iy = juce::jmin(static_cast<int>(fy), gridSize - 2);
+    const float tx = fx - static_cast<float>(ix);
+    const float ty = fy - static_cast<float>(iy);
+
+    const float* p00 = grid + (iy * gridSize + ix) * numCorners;
+    const float* p10 = p00 + numCorners;
+    const float* p01 = p00 + gridSize * numCorners;
+    const float* p11 = p01 + numCorners;
+
+    CornerWeights weights {};
+    for (int c = 0; c < numCorners; ++c)
+    {
+        const float top    = p00[c] + tx * (p10[c] - p00[c]);
+        const float bottom = p01[c] + tx * (p11[c] - p01[c]);
+        weights[c] = top + ty * (bottom - top);
+    }
+    return weights;
+}
+
+} // namespace JackDistortion
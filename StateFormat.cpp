@@ -0,0 +1,392 @@
+#include "StateFormat.h"
+
+namespace Service
+{
+    namespace
+    {
+        float missingValue() noexcept { return std::numeric_limits<float>::quiet_NaN(); }
+
+        bool looksLikeXml(const void* data, size_t sizeInBytes) noexcept
+        {
+            auto* bytes = static_cast<const juce::uint8*>(data);
+            size_t i = 0;
+            if (sizeInBytes >= 3 && bytes[0] == 0xef && bytes[1] == 0xbb && bytes[2] == 0xbf)   // UTF-8 byte order mark
+                i = 3;
+
+            while (i < sizeInBytes && juce::CharacterFunctions::isWhitespace(static_cast<char>(bytes[i])))
+                ++i;
+
+            return i < sizeInBytes && bytes[i] == '<';
+        }
+
+        // The two formats from before the binary one, as a ValueTree.
+        juce::ValueTree readLegacyTree(const void* data, size_t sizeInBytes)
+        {
+            if (looksLikeXml(data, sizeInBytes))
+            {
+                auto xml = juce::parseXML(juce::String::createStringFromData(data, static_cast<int>(sizeInBytes)));
+                return xml != nullptr ? juce::ValueTree::fromXml(*xml) : juce::ValueTree();
+            }
+
+            return juce::ValueTree::readFromData(data, sizeInBytes);
+        }
+
+        void copyProperties(const juce::ValueTree& tree, juce::NamedValueSet& properties)
+        {
+            properties.clear();
+            for (int i = 0; i < tree.getNumProperties(); ++i)
+            {
+                const auto name = tree.getPropertyName(i);
+                properties.set(name, tree.getProperty(name));
+            }
+        }
+    }
+
+    const juce::Identifier StateFormat::extensionsType { "EXTENSIONS" };
+    const juce::Identifier StateFormat::chunkType { "CHUNK" };
+    const juce::Identifier StateFormat::chunkIdProperty { "fourcc" };   // not "id", which APVTS looks for
+    const juce::Identifier StateFormat::chunkDataProperty { "data" };
+
+    StateFormat::StateFormat(juce::AudioProcessorValueTreeState& apvts)
+        : valueTreeState(apvts)
+    {
+        for (auto* parameter : apvts.processor.getParameters())
+        {
+            if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            {
+                // Every parameter needs its own, non-zero ParameterID version to have a slot.
+                const int slot = ranged->getVersionHint();
+                jassert(slot > 0 && std::find(slots.begin(), slots.end(), slot) == slots.end());
+
+                parameters.push_back(ranged);
+                slots.push_back(slot);
+                numSlots = juce::jmax(numSlots, slot + 1);
+            }
+        }
+    }
+
+    bool StateFormat::isBinaryState(const void* data, size_t sizeInBytes) noexcept
+    {
+        return sizeInBytes >= static_cast<size_t>(headerSize)
+            && juce::ByteOrder::littleEndianInt(data) == magic;
+    }
+
+    //==============================================================================
+    void StateFormat::write(juce::OutputStream& output) const
+    {
+        output.writeInt(static_cast<int>(magic));
+        output.writeShort(static_cast<short>(currentVersion));
+        output.writeShort(0);
+        output.writeInt(numSlots);
+
+        std::vector<float> values(static_cast<size_t>(numSlots), missingValue());
+        for (size_t i = 0; i < parameters.size(); ++i)
+            values[static_cast<size_t>(slots[i])] = parameters[i]->convertFrom0to1(parameters[i]->getValue());
+
+        for (auto value : values)
+            output.writeFloat(value);
+
+        juce::MemoryOutputStream properties;
+        const auto& state = valueTreeState.state;
+        properties.writeCompressedInt(state.getNumProperties());
+        for (int i = 0; i < state.getNumProperties(); ++i)
+        {
+            const auto name = state.getPropertyName(i);
+            properties.writeString(name.toString());
+            properties.writeString(state.getProperty(name).toString());
+        }
+
+        output.writeInt(static_cast<int>(propertiesChunkId));
+        output.writeInt(static_cast<int>(properties.getDataSize()));
+        output.write(properties.getData(), properties.getDataSize());
+
+        for (const auto& chunk : state.getChildWithName(extensionsType))
+        {
+            if (const auto* data = chunk.getProperty(chunkDataProperty).getBinaryData())
+            {
+                output.writeInt(static_cast<int>(chunk.getProperty(chunkIdProperty)));
+                output.writeInt(static_cast<int>(data->getSize()));
+                output.write(data->getData(), data->getSize());
+            }
+        }
+    }
+
+    void StateFormat::write(juce::MemoryBlock& destData) const
+    {
+        juce::MemoryOutputStream output(destData, false);
+        write(output);
+    }
+
+    //==============================================================================
+    bool StateFormat::read(const void* data, size_t sizeInBytes, Snapshot& result, juce::String* errorMessage) const
+    {
+        juce::String error;
+        bool ok = false;
+
+        if (data == nullptr || sizeInBytes == 0)
+        {
+            error = "is empty";
+        }
+        else if (isBinaryState(data, sizeInBytes))
+        {
+            ok = readBinary(data, sizeInBytes, numSlots, result, error);
+        }
+        else
+        {
+            // XML preset files, or the ValueTree stream host sessions were saved as.
+            ok = readTree(readLegacyTree(data, sizeInBytes), result, error);
+        }
+
+        if (errorMessage != nullptr)
+            *errorMessage = error;
+
+        return ok;
+    }
+
+    bool StateFormat::peek(const void* data, size_t sizeInBytes, const std::vector<ParameterKey>& keys,
+                           std::vector<float>& values, juce::NamedValueSet& properties)
+    {
+        values.assign(keys.size(), missingValue());
+        properties.clear();
+
+        if (data == nullptr || sizeInBytes == 0)
+            return false;
+
+        if (isBinaryState(data, sizeInBytes))
+        {
+            Snapshot snapshot;
+            juce::String error;
+            if (! readBinary(data, sizeInBytes, 0, snapshot, error))
+                return false;
+
+            for (size_t i = 0; i < keys.size(); ++i)
+                if (keys[i].slot > 0 && static_cast<size_t>(keys[i].slot) < snapshot.values.size())
+                    values[i] = snapshot.values[static_cast<size_t>(keys[i].slot)];
+
+            properties = std::move(snapshot.properties);
+            return true;
+        }
+
+        const auto tree = readLegacyTree(data, sizeInBytes);
+        if (! tree.isValid())
+            return false;
+
+        copyProperties(tree, properties);
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            auto child = tree.getChildWithProperty("id", keys[i].id);
+            if (child.hasProperty("value"))
+                values[i] = static_cast<float>(child.getProperty("value"));
+        }
+
+        return true;
+    }
+
+    bool StateFormat::readBinary(const void* data, size_t sizeInBytes, int minimumSlots, Snapshot& result, juce::String& error)
+    {
+        juce::MemoryInputStream input(data, sizeInBytes, false);
+        input.readInt();   // magic, checked by the caller
+
+        const int version = static_cast<juce::uint16>(input.readShort());
+        input.readShort();  // flags
+        if (version > currentVersion)
+        {
+            error = "was saved by a newer version (format " + juce::String(version) + ")";
+            return false;
+        }
+
+        const auto slotsInData = static_cast<juce::uint32>(input.readInt());
+        if (slotsInData > (sizeInBytes - static_cast<size_t>(headerSize)) / sizeof(float))
+        {
+            error = "is truncated";
+            return false;
+        }
+
+        result.values.assign(static_cast<size_t>(juce::jmax(minimumSlots, static_cast<int>(slotsInData))), missingValue());
+        for (juce::uint32 i = 0; i < slotsInData; ++i)
+            result.values[i] = input.readFloat();
+
+        result.properties.clear();
+        result.extensions.clear();
+
+        while (input.getNumBytesRemaining() >= 8)
+        {
+            const auto id = static_cast<juce::uint32>(input.readInt());
+            const auto size = static_cast<juce::uint32>(input.readInt());
+            if (size > static_cast<juce::uint64>(input.getNumBytesRemaining()))
+            {
+                error = "has a truncated chunk";
+                return false;
+            }
+
+            if (id == propertiesChunkId)
+            {
+                juce::MemoryInputStream properties(static_cast<const char*>(data) + input.getPosition(), size, false);
+                for (int count = properties.readCompressedInt(); count > 0 && ! properties.isExhausted(); --count)
+                {
+                    const auto name = properties.readString();
+                    const auto value = properties.readString();
+                    if (name.isNotEmpty())
+                        result.properties.set(name, value);
+                }
+                input.skipNextBytes(size);
+            }
+            else
+            {
+                Chunk chunk;
+                chunk.id = id;
+                input.readIntoMemoryBlock(chunk.data, static_cast<juce::ssize_t>(size));
+                result.extensions.push_back(std::move(chunk));
+            }
+        }
+
+        return true;
+    }
+
+    bool StateFormat::readTree(const juce::ValueTree& tree, Snapshot& result, juce::String& error) const
+    {
+        if (! tree.isValid() || ! tree.hasType(valueTreeState.state.getType()))
+        {
+            error = "is not a state for this plugin";
+            return false;
+        }
+
+        result.values.assign(static_cast<size_t>(numSlots), missingValue());
+        result.extensions.clear();
+        copyProperties(tree, result.properties);
+
+        for (size_t i = 0; i < parameters.size(); ++i)
+        {
+            auto child = tree.getChildWithProperty("id", parameters[i]->paramID);
+            if (child.hasProperty("value"))
+                result.values[static_cast<size_t>(slots[i])] = static_cast<float>(child.getProperty("value"));
+        }
+
+        // A tree saved after a binary blob was loaded carries its extension chunks along. The
+        // stream keeps them binary; XML turns them into MemoryBlock's base64 text.
+        for (const auto& child : tree.getChildWithName(extensionsType))
+        {
+            const auto& data = child.getProperty(chunkDataProperty);
+            Chunk chunk;
+            chunk.id = static_cast<juce::uint32>(static_cast<int>(child.getProperty(chunkIdProperty)));
+
+            if (const auto* block = data.getBinaryData())
+                chunk.data = *block;
+            else if (! chunk.data.fromBase64Encoding(data.toString()))
+                continue;
+
+            result.extensions.push_back(std::move(chunk));
+        }
+
+        return true;
+    }
+
+    //==============================================================================
+    std::vector<float> StateFormat::getNormalisedValues(const Snapshot& snapshot) const
+    {
+        // Same rules as replaceState(): a parameter the state does not mention goes back to its default.
+        std::vector<float> normalised;
+        normalised.reserve(parameters.size());
+
+        for (size_t i = 0; i < parameters.size(); ++i)
+        {
+            const auto slot = static_cast<size_t>(slots[i]);
+            const float stored = slot < snapshot.values.size() ? snapshot.values[slot] : missingValue();
+            normalised.push_back(std::isfinite(stored) ? parameters[i]->convertTo0to1(stored)
+                                                       : parameters[i]->getDefaultValue());
+        }
+
+        return normalised;
+    }
+
+    void StateFormat::apply(const Snapshot& snapshot) const
+    {
+        const auto values = getNormalisedValues(snapshot);
+        for (size_t i = 0; i < parameters.size(); ++i)
+            if (parameters[i]->getValue() != values[i])
+                parameters[i]->setValueNotifyingHost(values[i]);
+
+        applyProperties(snapshot.properties);
+        applyExtensions(snapshot.extensions);
+    }
+
+    void StateFormat::applyProperties(const juce::NamedValueSet& properties) const
+    {
+        // A property the incoming state does not have, its tags say, must not stay behind from
+        // whatever was loaded before and end up saved into the next preset.
+        auto& state = valueTreeState.state;
+        for (int i = state.getNumProperties(); --i >= 0;)
+        {
+            const auto name = state.getPropertyName(i);
+            if (! properties.contains(name))
+                state.removeProperty(name, nullptr);
+        }
+
+        for (const auto& property : properties)
+            state.setProperty(property.name, property.value, nullptr);
+    }
+
+    void StateFormat::applyExtensions(const std::vector<Chunk>& extensions) const
+    {
+        auto& state = valueTreeState.state;
+        auto existing = state.getChildWithName(extensionsType);
+        if (! existing.isValid() && extensions.empty())
+            return;
+
+        state.removeChild(existing, nullptr);
+        if (extensions.empty())
+            return;
+
+        juce::ValueTree chunks(extensionsType);
+        for (const auto& chunk : extensions)
+        {
+            juce::ValueTree child(chunkType);
+            child.setProperty(chunkIdProperty, static_cast<int>(chunk.id), nullptr);
+            child.setProperty(chunkDataProperty, chunk.data, nullptr);
+            chunks.appendChild(child, nullptr);
+        }
+        state.appendChild(chunks, nullptr);
+    }
+
+    //==============================================================================
+    CachedState::CachedState(const StateFormat& formatToUse, juce::AudioProcessorValueTreeState& apvts)
+        : format(formatToUse), valueTreeState(apvts)
+    {
+        for (auto* parameter : format.getParameters())
+            parameter->addListener(this);
+
+        valueTreeState.state.addListener(this);
+    }
+
+    CachedState::~CachedState()
+    {
+        for (auto* parameter : format.getParameters())
+            parameter->removeListener(this);
+
+        valueTreeState.state.removeListener(this);
+    }
+
+    void CachedState::appendTo(juce::MemoryBlock& destData)
+    {
+        const juce::ScopedLock sl(lock);
+
+        // Read the counter before encoding: a change that lands mid-write moves it again, so the
+        // blob is never kept as current when it might miss that change.
+        const auto current = generation.load();
+        if (current != blobGeneration)
+        {
+            format.write(blob);
+            blobGeneration = current;
+        }
+
+        destData.append(blob.getData(), blob.getSize());
+    }
+
+    void CachedState::valueTreePropertyChanged(juce::ValueTree& tree, const juce::Identifier&)
+    {
+        // Parameters are covered by their own listeners; APVTS mirroring them into the PARAM
+        // children is not a change of its own.
+        if (tree == valueTreeState.state)
+            markDirty();
+    }
+}
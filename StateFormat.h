@@ -0,0 +1,141 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace Service
+{
+    //==============================================================================
+    // Compact binary encoding of the plugin state, used for host sessions and preset files alike.
+    //
+    //   header  "OXst" magic, uint16 format version, uint16 flags (zero), uint32 slot count
+    //   values  one float32 per slot: the parameter whose ParameterID version is the slot number,
+    //           denormalised as APVTS stores it; NaN for slots with no parameter (slot 0 included)
+    //   chunks  until the end: fourcc, uint32 byte size, payload. "PROP" holds the state's own
+    //           properties. Chunks a build does not know are kept in the state, under an
+    //           EXTENSIONS child, and written back unchanged, which leaves room for curves or
+    //           sequences later without a format version change or losing them to an older build.
+    //
+    // All numbers are little-endian. Parameters are found by their ParameterID version, which is
+    // never reused, so a blob from an older build fills the slots it has and leaves the rest at
+    // their defaults. The version in the header only moves if this layout itself changes.
+    //
+    // read() also accepts what earlier builds wrote: the ValueTree stream getStateInformation used
+    // and the XML of preset files. Those are migrated into the same Snapshot.
+    class StateFormat
+    {
+    public:
+        static constexpr juce::uint32 magic = 0x7473584f;   // "OXst" read as little-endian
+        static constexpr int currentVersion = 1;
+        static constexpr int headerSize = 12;
+
+        struct Chunk
+        {
+            juce::uint32 id = 0;
+            juce::MemoryBlock data;
+        };
+
+        // A decoded state, not yet applied.
+        struct Snapshot
+        {
+            std::vector<float> values;        // by slot, denormalised; NaN where the blob has none
+            juce::NamedValueSet properties;
+            std::vector<Chunk> extensions;    // chunks this build does not understand
+        };
+
+        explicit StateFormat(juce::AudioProcessorValueTreeState& apvts);
+
+        /** Encodes the current parameter values and state properties. */
+        void write(juce::OutputStream& output) const;
+        void write(juce::MemoryBlock& destData) const;
+
+        /** Decodes the binary format or either of the older ones. Returns false, with the reason
+            in errorMessage, if the data is none of them or belongs to another plugin. Only reads
+            the parameter list, so it is safe on any thread. */
+        bool read(const void* data, size_t sizeInBytes, Snapshot& result, juce::String* errorMessage = nullptr) const;
+
+        /** The snapshot's value for each parameter, normalised and in the processor's parameter
+            order; defaults fill the gaps. */
+        std::vector<float> getNormalisedValues(const Snapshot& snapshot) const;
+
+        /** Sets every parameter, then the state properties and extension chunks. Message thread. */
+        void apply(const Snapshot& snapshot) const;
+
+        /** Makes the state's own properties exactly these, removing any the set lacks, as
+            replaceState() did. Message thread. */
+        void applyProperties(const juce::NamedValueSet& properties) const;
+
+        /** Replaces the extension chunks kept in the state, which write() emits after "PROP".
+            Message thread. */
+        void applyExtensions(const std::vector<Chunk>& extensions) const;
+
+        /** The processor's parameters, in its own order. */
+        const std::vector<juce::RangedAudioParameter*>& getParameters() const noexcept { return parameters; }
+
+        static bool isBinaryState(const void* data, size_t sizeInBytes) noexcept;
+
+        // A parameter named both ways: binary blobs store the ParameterID version, older ones the ID.
+        struct ParameterKey
+        {
+            juce::String id;
+            int slot = 0;
+        };
+
+        /** Reads the state properties and just the listed parameters' denormalised values (NaN
+            where missing) from any of the formats, without a processor. For indexing presets. */
+        static bool peek(const void* data, size_t sizeInBytes, const std::vector<ParameterKey>& keys,
+                         std::vector<float>& values, juce::NamedValueSet& properties);
+
+    private:
+        static constexpr juce::uint32 propertiesChunkId = 0x504f5250;   // "PROP"
+        static const juce::Identifier extensionsType, chunkType, chunkIdProperty, chunkDataProperty;
+
+        static bool readBinary(const void* data, size_t sizeInBytes, int minimumSlots, Snapshot& result, juce::String& error);
+        bool readTree(const juce::ValueTree& tree, Snapshot& result, juce::String& error) const;
+
+        juce::AudioProcessorValueTreeState& valueTreeState;
+        std::vector<juce::RangedAudioParameter*> parameters;
+        std::vector<int> slots;   // per parameter
+        int numSlots = 0;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StateFormat)
+    };
+
+    //==============================================================================
+    // The last blob StateFormat wrote, reused until something in the state changes. Hosts ask for
+    // the state on every autosave and undo snapshot, some on every parameter poll, and across a
+    // session with a hundred or more instances encoding it from scratch each time adds up.
+    // Parameter listeners and a listener on the state's own properties and children, where the
+    // extension chunks live, bump a generation counter; the blob is only written again when the
+    // counter has moved since it was cached.
+    class CachedState : private juce::AudioProcessorParameter::Listener,
+                        private juce::ValueTree::Listener
+    {
+    public:
+        CachedState(const StateFormat& formatToUse, juce::AudioProcessorValueTreeState& apvts);
+        ~CachedState() override;
+
+        /** Appends the current state to destData, encoding it only if it changed since last time. */
+        void appendTo(juce::MemoryBlock& destData);
+
+        /** Forces the next call to encode, for changes no listener sees. */
+        void markDirty() noexcept { ++generation; }
+
+    private:
+        void parameterValueChanged(int, float) override             { markDirty(); }
+        void parameterGestureChanged(int, bool) override            {}
+        void valueTreePropertyChanged(juce::ValueTree& tree, const juce::Identifier&) override;
+        void valueTreeChildAdded(juce::ValueTree&, juce::ValueTree&) override        { markDirty(); }
+        void valueTreeChildRemoved(juce::ValueTree&, juce::ValueTree&, int) override { markDirty(); }
+        void valueTreeRedirected(juce::ValueTree&) override                          { markDirty(); }
+
+        const StateFormat& format;
+        juce::AudioProcessorValueTreeState& valueTreeState;
+
+        std::atomic<juce::uint32> generation { 1 };   // bumped from any thread
+        juce::CriticalSection lock;
+        juce::MemoryBlock blob;
+        juce::uint32 blobGeneration = 0;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CachedState)
+    };
+}
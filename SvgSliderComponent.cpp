@@ -2,34 +2,77 @@
 
 SvgSliderComponent::SvgSliderComponent (const void* trackSvgData, int trackSvgDataSize,
                                         const void* thumbSvgData, int thumbSvgDataSize)
-    : juce::Slider(juce::Slider::LinearVertical, juce::Slider::TextBoxBelow)
+    : juce::Slider(juce::Slider::LinearVertical, juce::Slider::TextBoxBelow),
+      trackSvg (trackSvgData), thumbSvg (thumbSvgData),
+      trackSvgSize (trackSvgDataSize), thumbSvgSize (thumbSvgDataSize)
 {
+    setSliderStyle (juce::Slider::LinearVertical);
+    setTextBoxStyle (juce::Slider::TextBoxBelow, false, 50, 20);
+}
+
+SvgSliderComponent::~SvgSliderComponent()
+{
+}
+
+juce::Image SvgSliderComponent::RasterCache::getImage (const void* svgData, int svgDataSize, int pixelWidth, int pixelHeight,
+                                                       juce::RectanglePlacement placement)
+{
+    const Key key { svgData, pixelWidth, pixelHeight, placement.getFlags() };
+    auto found = images.find (key);
+    if (found != images.end())
+        return found->second;
+
+    // Parsed once; an SVG that fails to parse is remembered as such.
+    auto drawable = drawables.find (svgData);
+    if (drawable == drawables.end())
     {
-        juce::MemoryInputStream trackStream (trackSvgData, trackSvgDataSize, false);
-        trackDrawable = juce::Drawable::createFromImageDataStream (trackStream);
+        juce::MemoryInputStream stream (svgData, static_cast<size_t> (svgDataSize), false);
+        drawable = drawables.emplace (svgData, juce::Drawable::createFromImageDataStream (stream)).first;
     }
+
+    if (drawable->second == nullptr)
+        return {};
+
+    juce::Image image (juce::Image::ARGB, pixelWidth, pixelHeight, true);
     {
-        juce::MemoryInputStream thumbStream (thumbSvgData, thumbSvgDataSize, false);
-        thumbDrawable = juce::Drawable::createFromImageDataStream (thumbStream);
+        juce::Graphics g (image);
+        drawable->second->drawWithin (g, juce::Rectangle<float> (static_cast<float> (pixelWidth), static_cast<float> (pixelHeight)),
+                                      placement, 1.0f);
     }
-    
-    setSliderStyle (juce::Slider::LinearVertical);
-    setTextBoxStyle (juce::Slider::TextBoxBelow, false, 50, 20);
+
+    // Drop the images no slider holds any more, e.g. the sizes an editor was resized through.
+    for (auto it = images.begin(); it != images.end();)
+        it = it->second.getReferenceCount() <= 1 ? images.erase (it) : std::next (it);
+
+    images.emplace (key, image);
+    return image;
 }
 
-SvgSliderComponent::~SvgSliderComponent()
+juce::Image& SvgSliderComponent::getImage (juce::Image& held, const void* svgData, int svgDataSize,
+                                           juce::Rectangle<float> area, float scale, juce::RectanglePlacement placement)
 {
+    const int pixelWidth  = juce::roundToInt (area.getWidth()  * scale);
+    const int pixelHeight = juce::roundToInt (area.getHeight() * scale);
+
+    if (pixelWidth <= 0 || pixelHeight <= 0)
+        held = {};
+    else if (held.isNull() || held.getWidth() != pixelWidth || held.getHeight() != pixelHeight)
+        held = rasterCache->getImage (svgData, svgDataSize, pixelWidth, pixelHeight, placement);
+
+    return held;
 }
 
 void SvgSliderComponent::paint (juce::Graphics& g)
 {
     auto bounds = getLocalBounds().toFloat();
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
 
     auto trackArea = bounds.reduced(0.0f, 25.0f);  //  vertical padding
 
     // track
-    if (trackDrawable)
-        trackDrawable->drawWithin(g, trackArea, juce::RectanglePlacement::stretchToFit, 1.0f);
+    auto& track = getImage (trackImage, trackSvg, trackSvgSize, trackArea, scale, juce::RectanglePlacement::stretchToFit);
+    if (track.isValid())
+        g.drawImage (track, trackArea);
 
     // Thumb positioning
     float minValue = (float)getMinimum();
@@ -41,11 +84,13 @@ void SvgSliderComponent::paint (juce::Graphics& g)
     float thumbWidth = bounds.getWidth();
     float thumbY = juce::jmap(proportion, trackArea.getBottom(), trackArea.getY());
 
-    juce::Rectangle<float> thumbRect(bounds.getX(), thumbY - (thumbHeight * 0.5f), thumbWidth, thumbHeight);
+    // Whole pixels, so moving the thumb is a straight copy rather than a resampled draw.
+    juce::Rectangle<float> thumbRect(bounds.getX(), std::round (thumbY - (thumbHeight * 0.5f)), thumbWidth, thumbHeight);
 
-    if (thumbDrawable)
+    auto& thumb = getImage (thumbImage, thumbSvg, thumbSvgSize, thumbRect, scale, juce::RectanglePlacement::centred);
+    if (thumb.isValid())
     {
-        thumbDrawable->drawWithin(g, thumbRect, juce::RectanglePlacement::centred, 1.0f);
+        g.drawImage (thumb, thumbRect);
     }
     else
     {
@@ -1,11 +1,13 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <map>
 
 class SvgSliderComponent : public juce::Slider
 {
 public:
 
+    // The SVG data is read in place and must outlive the slider, as BinaryData does.
     SvgSliderComponent (const void* trackSvgData, int trackSvgDataSize,
                         const void* thumbSvgData, int thumbSvgDataSize);
     ~SvgSliderComponent() override;
@@ -14,7 +16,29 @@ public:
     juce::Slider& getSlider() { return *this; }
 
 private:
-    // Drawable for the SVG track.
-    std::unique_ptr<juce::Drawable> trackDrawable;
-    std::unique_ptr<juce::Drawable> thumbDrawable;};
+    // Parsed SVGs and their rasterised images, shared by every slider in the process. Each image
+    // is rendered once per size and display scale; after that painting only blits it.
+    class RasterCache
+    {
+    public:
+        juce::Image getImage (const void* svgData, int svgDataSize, int pixelWidth, int pixelHeight,
+                              juce::RectanglePlacement placement);
 
+    private:
+        using Key = std::tuple<const void*, int, int, int>;   // SVG, pixel width, pixel height, placement
+
+        std::map<const void*, std::unique_ptr<juce::Drawable>> drawables;
+        std::map<Key, juce::Image> images;
+    };
+
+    // The image for this area at this scale: the one already held if it still fits, otherwise
+    // one from the cache.
+    juce::Image& getImage (juce::Image& held, const void* svgData, int svgDataSize,
+                           juce::Rectangle<float> area, float scale, juce::RectanglePlacement placement);
+
+    const void* trackSvg;
+    const void* thumbSvg;
+    const int trackSvgSize, thumbSvgSize;
+
+    juce::SharedResourcePointer<RasterCache> rasterCache;
+    juce::Image trackImage, thumbImage;};
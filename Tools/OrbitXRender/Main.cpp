@@ -0,0 +1,612 @@
+// OrbitXRender: offline batch renderer built on OrbitXAudioProcessor.
+//
+// Streams each input file through the processor in fixed-size blocks and writes the result next
+// to the other renders in the output directory. Files are spread over worker threads, each of
+// which owns a single processor instance for its whole lifetime.
+
+#include <JuceHeader.h>
+#include "../../PluginProcessor.h"
+#include "../../DistortionBenchmark.h"
+#include "../../DistortionAccuracy.h"
+#include "../../LoudnessCompensation.h"
+
+namespace
+{
+    struct RenderSettings
+    {
+        juce::File outputDirectory;
+        juce::File presetFile;
+        std::vector<std::pair<juce::String, juce::String>> overrides; // parameter ID, value text
+        int blockSize = 512;
+        int numJobs = juce::SystemStats::getNumCpus();
+    };
+
+    juce::CriticalSection consoleLock;
+
+    void log(const juce::String& message)
+    {
+        const juce::ScopedLock sl(consoleLock);
+        std::cout << message << std::endl;
+    }
+
+    //==============================================================================
+    bool applyPreset(OrbitXAudioProcessor& processor, const juce::File& presetFile)
+    {
+        juce::MemoryBlock data;
+        Service::StateFormat::Snapshot snapshot;
+        if (! presetFile.loadFileAsData(data)
+            || ! processor.stateFormat.read(data.getData(), data.getSize(), snapshot))
+            return false;
+
+        processor.stateFormat.apply(snapshot);
+        return true;
+    }
+
+    bool applyOverride(OrbitXAudioProcessor& processor, const juce::String& parameterID, const juce::String& valueText)
+    {
+        auto* parameter = processor.apvts.getParameter(parameterID);
+        if (parameter == nullptr)
+            return false;
+
+        // Choice parameters accept either their item text or an index.
+        auto normalised = parameter->getValueForText(valueText);
+        if (valueText.containsOnly("0123456789.-"))
+            normalised = parameter->convertTo0to1(valueText.getFloatValue());
+
+        parameter->setValueNotifyingHost(normalised);
+        return true;
+    }
+
+    bool configureProcessor(OrbitXAudioProcessor& processor, const RenderSettings& settings)
+    {
+        if (settings.presetFile != juce::File() && ! applyPreset(processor, settings.presetFile))
+        {
+            log("Could not load preset " + settings.presetFile.getFullPathName());
+            return false;
+        }
+
+        for (auto& [id, value] : settings.overrides)
+            if (! applyOverride(processor, id, value))
+                log("Ignoring unknown parameter " + id);
+
+        return true;
+    }
+
+    //==============================================================================
+    std::unique_ptr<juce::AudioFormatReader> openReader(juce::AudioFormatManager& formats, const juce::File& file)
+    {
+        // WAV and AIFF can be memory-mapped, which avoids a copy through the stream buffer.
+        if (auto* format = formats.findFormatForFileExtension(file.getFileExtension()))
+        {
+            std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped(format->createMemoryMappedReader(file));
+            if (mapped != nullptr && mapped->mapEntireFile())
+                return mapped;
+        }
+
+        return std::unique_ptr<juce::AudioFormatReader>(formats.createReaderFor(file));
+    }
+
+    bool setChannelLayout(OrbitXAudioProcessor& processor, int numChannels)
+    {
+        auto set = juce::AudioChannelSet::canonicalChannelSet(numChannels);
+        if (set.isDisabled())
+            set = juce::AudioChannelSet::discreteChannels(numChannels);
+
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(set);
+        layout.outputBuses.add(set);
+        return processor.setBusesLayout(layout);
+    }
+
+    bool renderFile(OrbitXAudioProcessor& processor, juce::AudioFormatManager& formats,
+                    const juce::File& input, const RenderSettings& settings)
+    {
+        auto reader = openReader(formats, input);
+        if (reader == nullptr)
+        {
+            log("Could not open " + input.getFullPathName());
+            return false;
+        }
+
+        const int numChannels = static_cast<int>(reader->numChannels);
+        if (! setChannelLayout(processor, numChannels))
+        {
+            log("Unsupported channel count (" + juce::String(numChannels) + ") in " + input.getFileName());
+            return false;
+        }
+
+        const double sampleRate = reader->sampleRate;
+        processor.setRateAndBufferSizeDetails(sampleRate, settings.blockSize);
+        processor.prepareToPlay(sampleRate, settings.blockSize);
+        processor.reset();
+
+        auto outputFile = settings.outputDirectory.getChildFile(input.getFileName());
+        auto* outputFormat = formats.findFormatForFileExtension(input.getFileExtension());
+        outputFile.deleteFile();
+        std::unique_ptr<juce::OutputStream> stream(outputFile.createOutputStream());
+        if (stream == nullptr || outputFormat == nullptr)
+        {
+            log("Could not create " + outputFile.getFullPathName());
+            return false;
+        }
+
+        std::unique_ptr<juce::AudioFormatWriter> writer(outputFormat->createWriterFor(stream.get(), sampleRate,
+                                                                                       static_cast<unsigned int>(numChannels),
+                                                                                       static_cast<int>(reader->bitsPerSample),
+                                                                                       reader->metadataValues, 0));
+        if (writer == nullptr)
+        {
+            log("Could not create a writer for " + outputFile.getFullPathName());
+            return false;
+        }
+        stream.release(); // now owned by the writer
+
+        // Latency is compensated by dropping the first samples and flushing the same amount at the end.
+        const juce::int64 length = reader->lengthInSamples;
+        const juce::int64 latency = processor.getLatencySamples();
+        juce::AudioBuffer<float> block(numChannels, settings.blockSize);
+        juce::MidiBuffer midi;
+
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+        for (juce::int64 position = 0; position < length + latency; position += settings.blockSize)
+        {
+            const int num = static_cast<int>(juce::jmin<juce::int64>(settings.blockSize, length + latency - position));
+            block.setSize(numChannels, num, false, false, true);
+            block.clear();
+
+            if (position < length)
+                reader->read(&block, 0, static_cast<int>(juce::jmin<juce::int64>(num, length - position)), position, true, true);
+
+            processor.processBlock(block, midi);
+
+            const juce::int64 skip = juce::jlimit<juce::int64>(0, num, latency - position);
+            if (skip < num && ! writer->writeFromAudioSampleBuffer(block, static_cast<int>(skip), num - static_cast<int>(skip)))
+            {
+                log("Write failed for " + outputFile.getFullPathName());
+                return false;
+            }
+        }
+
+        const double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+        const double audioSeconds = static_cast<double>(length) / sampleRate;
+        log(input.getFileName() + " -> " + outputFile.getFullPathName()
+            + " (" + juce::String(audioSeconds / juce::jmax(seconds, 1.0e-9), 1) + "x realtime)");
+        return true;
+    }
+
+    //==============================================================================
+    class RenderWorker : public juce::Thread
+    {
+    public:
+        RenderWorker(const juce::Array<juce::File>& filesToRender, std::atomic<int>& nextFileIndex,
+                     std::atomic<int>& failureCount, const RenderSettings& renderSettings)
+            : juce::Thread("OrbitX render worker"),
+              files(filesToRender), nextFile(nextFileIndex), failures(failureCount), settings(renderSettings)
+        {
+            formats.registerBasicFormats();
+        }
+
+        void run() override
+        {
+            OrbitXAudioProcessor processor;
+            processor.setNonRealtime(true);
+
+            if (! configureProcessor(processor, settings))
+            {
+                failures += files.size();
+                return;
+            }
+
+            for (int index = nextFile++; index < files.size() && ! threadShouldExit(); index = nextFile++)
+                if (! renderFile(processor, formats, files.getReference(index), settings))
+                    ++failures;
+
+            processor.releaseResources();
+        }
+
+    private:
+        const juce::Array<juce::File>& files;
+        std::atomic<int>& nextFile;
+        std::atomic<int>& failures;
+        const RenderSettings& settings;
+        juce::AudioFormatManager formats;
+    };
+
+    //==============================================================================
+    void runRender(const juce::ArgumentList& args)
+    {
+        RenderSettings settings;
+        settings.outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile("rendered");
+        juce::Array<juce::File> files;
+
+        for (int i = 1; i < args.size(); ++i)
+        {
+            const auto& arg = args[i];
+            auto nextValue = [&]() -> juce::String
+            {
+                if (i + 1 >= args.size())
+                    juce::ConsoleApplication::fail("Missing value for " + arg.text);
+                return args[++i].text;
+            };
+
+            if (arg == "--output|-o")
+                settings.outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(nextValue());
+            else if (arg == "--preset|-p")
+                settings.presetFile = juce::File::getCurrentWorkingDirectory().getChildFile(nextValue());
+            else if (arg == "--set|-s")
+            {
+                auto assignment = nextValue();
+                if (! assignment.contains("="))
+                    juce::ConsoleApplication::fail("Expected ID=value after --set, got " + assignment);
+                settings.overrides.emplace_back(assignment.upToFirstOccurrenceOf("=", false, false).trim(),
+                                                assignment.fromFirstOccurrenceOf("=", false, false).trim());
+            }
+            else if (arg == "--quality|-q")
+                settings.overrides.emplace_back("RenderQuality", nextValue()); // the tool renders offline
+            else if (arg == "--block-size")
+                settings.blockSize = juce::jlimit(16, 8192, nextValue().getIntValue());
+            else if (arg == "--jobs|-j")
+                settings.numJobs = juce::jmax(1, nextValue().getIntValue());
+            else if (arg.isOption())
+                juce::ConsoleApplication::fail("Unknown option " + arg.text);
+            else
+                files.add(arg.resolveAsExistingFile());
+        }
+
+        if (files.isEmpty())
+            juce::ConsoleApplication::fail("No input files given");
+
+        // Renders are named after their input, so two inputs with one name would race for the
+        // same output file, and an input in the output directory would be overwritten.
+        for (int i = 0; i < files.size(); ++i)
+        {
+            if (files[i].getParentDirectory() == settings.outputDirectory)
+                juce::ConsoleApplication::fail(files[i].getFullPathName() + " is in the output directory");
+
+            for (int j = 0; j < i; ++j)
+                if (files[j].getFileName().equalsIgnoreCase(files[i].getFileName()))
+                    juce::ConsoleApplication::fail(files[j].getFullPathName() + " and " + files[i].getFullPathName()
+                                                   + " would both render to " + files[i].getFileName());
+        }
+
+        auto result = settings.outputDirectory.createDirectory();
+        if (result.failed())
+            juce::ConsoleApplication::fail("Could not create output directory: " + result.getErrorMessage());
+
+        std::atomic<int> nextFile { 0 };
+        std::atomic<int> failures { 0 };
+
+        juce::OwnedArray<RenderWorker> workers;
+        for (int i = 0; i < juce::jmin(settings.numJobs, files.size()); ++i)
+            workers.add(new RenderWorker(files, nextFile, failures, settings))->startThread();
+
+        for (auto* worker : workers)
+            worker->waitForThreadToExit(-1);
+
+        if (failures > 0)
+            juce::ConsoleApplication::fail(juce::String(failures.load()) + " of " + juce::String(files.size())
+                                           + " files failed to render");
+    }
+
+    void runBenchmark(const juce::ArgumentList& args)
+    {
+        JackDistortion::Benchmark::Options options;
+        if (args.containsOption("--blocks"))
+            options.numBlocks = juce::jmax(1, args.getValueForOption("--blocks").getIntValue());
+
+        // Runs a narrower kernel path than the CPU supports, to compare paths on one machine.
+        if (args.containsOption("--isa"))
+        {
+            using JackDistortion::Kernels::InstructionSet;
+            const auto requested = args.getValueForOption("--isa");
+            bool found = false;
+            for (auto set : { InstructionSet::generic, InstructionSet::avx2, InstructionSet::avx512 })
+            {
+                if (requested.equalsIgnoreCase(JackDistortion::Kernels::getInstructionSetName(set)))
+                {
+                    JackDistortion::Kernels::setInstructionSet(set);
+                    found = true;
+                }
+            }
+
+            if (! found)
+                juce::ConsoleApplication::fail("Unknown instruction set: " + requested);
+        }
+
+        std::cout << JackDistortion::Benchmark::formatReport(JackDistortion::Benchmark::runAll(options)) << std::endl;
+        std::cout << JackDistortion::Accuracy::formatTierReport({}) << std::endl;
+    }
+
+    // Times what a host does to every instance when it scans the plugin or loads a session:
+    // construct, prepareToPlay, one block, destroy. The first cycle is timed as well, since that
+    // is the one a scan pays for, and the run fails if the median or the first cycle goes over
+    // the budget.
+    void runInstantiationBenchmark(const juce::ArgumentList& args)
+    {
+        const int numCycles = args.containsOption("--cycles") ? juce::jmax(1, args.getValueForOption("--cycles").getIntValue()) : 200;
+        const double budgetMs = args.containsOption("--budget") ? args.getValueForOption("--budget").getDoubleValue() : 10.0;
+        const double sampleRate = 48000.0;
+        const int blockSize = 512;
+
+        juce::AudioBuffer<float> block(2, blockSize);
+        juce::MidiBuffer midi;
+        std::vector<double> cycleMs;
+
+        for (int cycle = 0; cycle < numCycles; ++cycle)
+        {
+            const auto startTicks = juce::Time::getHighResolutionTicks();
+            {
+                OrbitXAudioProcessor processor;
+                processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+                processor.prepareToPlay(sampleRate, blockSize);
+                block.clear();
+                processor.processBlock(block, midi);
+                processor.releaseResources();
+            }
+            cycleMs.push_back(juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1000.0);
+        }
+
+        const double firstMs = cycleMs.front();
+        std::sort(cycleMs.begin(), cycleMs.end());
+        const double medianMs = cycleMs[cycleMs.size() / 2];
+        const double worstMs = cycleMs.back();
+
+        std::cout << "Construct -> prepareToPlay -> first block -> destroy, " << numCycles << " cycles" << std::endl
+                  << "  first:  " << juce::String(firstMs, 3) << " ms" << std::endl
+                  << "  median: " << juce::String(medianMs, 3) << " ms" << std::endl
+                  << "  worst:  " << juce::String(worstMs, 3) << " ms" << std::endl
+                  << "  budget: " << juce::String(budgetMs, 3) << " ms" << std::endl;
+
+        if (medianMs > budgetMs || firstMs > budgetMs)
+            juce::ConsoleApplication::fail("Instantiation is over budget");
+    }
+
+    // Makes the pre-scaled copies of the editor artwork in Assets from the full-size sources in
+    // Artwork, so the editor never decodes or resamples the large originals. The image is halved
+    // until it is within a factor of two of the target and then scaled once, which keeps large
+    // reductions from aliasing.
+    void runScaleImage(const juce::ArgumentList& args)
+    {
+        if (args.size() < 5)
+            juce::ConsoleApplication::fail("Expected --scale-image source width height output");
+
+        auto source = juce::ImageFileFormat::loadFrom(args[1].resolveAsExistingFile());
+        const int width = args[2].text.getIntValue();
+        const int height = args[3].text.getIntValue();
+        if (! source.isValid() || width <= 0 || height <= 0)
+            juce::ConsoleApplication::fail("Could not read " + args[1].text + " or the size is not valid");
+
+        auto image = source.convertedToFormat(juce::Image::ARGB);
+        while (image.getWidth() >= width * 2 && image.getHeight() >= height * 2)
+            image = image.rescaled(image.getWidth() / 2, image.getHeight() / 2, juce::Graphics::highResamplingQuality);
+        image = image.rescaled(width, height, juce::Graphics::highResamplingQuality);
+
+        auto output = args[4].resolveAsFile();
+        output.deleteFile();
+        juce::FileOutputStream stream(output);
+        juce::PNGImageFormat png;
+        if (! stream.openedOk() || ! png.writeImageToStream(image, stream))
+            juce::ConsoleApplication::fail("Could not write " + output.getFullPathName());
+    }
+
+    void runWriteGolden(const juce::ArgumentList& args)
+    {
+        if (args.size() < 2)
+            juce::ConsoleApplication::fail("Expected --write-golden dir");
+
+        auto directory = args[1].resolveAsFile();
+        if (! JackDistortion::Accuracy::writeReferences(directory, {}))
+            juce::ConsoleApplication::fail("Could not write all references to " + directory.getFullPathName());
+    }
+
+    void runCheckGolden(const juce::ArgumentList& args)
+    {
+        if (args.size() < 2)
+            juce::ConsoleApplication::fail("Expected --check-golden dir");
+
+        auto results = JackDistortion::Accuracy::checkAgainstReferences(args[1].resolveAsExistingFolder(), {}, {});
+        std::cout << JackDistortion::Accuracy::formatCheckReport(results) << std::endl;
+
+        for (auto& r : results)
+            if (! r.passed)
+                juce::ConsoleApplication::fail("Golden-output check failed");
+    }
+
+    //==============================================================================
+    // State round trip and migration. A processor is given a value for every parameter, a preset
+    // name and a chunk this build does not know, then saved the three ways a host or preset file
+    // may hold it: the binary format, the preset XML and the ValueTree stream of older sessions.
+    // Each is loaded into a fresh processor, which has to come back with the same values,
+    // properties and chunk; the binary one also has to save back byte for byte.
+    struct SavedState
+    {
+        std::vector<float> values;   // normalised, in the processor's parameter order
+        juce::NamedValueSet properties;
+        juce::MemoryBlock binary;
+    };
+
+    SavedState saveState(OrbitXAudioProcessor& processor)
+    {
+        SavedState saved;
+        for (auto* parameter : processor.stateFormat.getParameters())
+            saved.values.push_back(parameter->getValue());
+
+        const auto& state = processor.apvts.state;
+        for (int i = 0; i < state.getNumProperties(); ++i)
+            saved.properties.set(state.getPropertyName(i), state.getProperty(state.getPropertyName(i)).toString());
+
+        processor.getStateInformation(saved.binary);
+        return saved;
+    }
+
+    juce::String compareStates(const OrbitXAudioProcessor& processor, const SavedState& expected,
+                               const SavedState& actual, bool sameBytes)
+    {
+        const auto& parameters = processor.stateFormat.getParameters();
+        for (size_t i = 0; i < parameters.size(); ++i)
+            if (std::abs(expected.values[i] - actual.values[i]) > 1.0e-5f)
+                return parameters[i]->paramID + " came back as " + juce::String(actual.values[i])
+                       + " instead of " + juce::String(expected.values[i]);
+
+        if (expected.properties != actual.properties)
+            return "state properties differ";
+
+        Service::StateFormat::Snapshot expectedSnapshot, actualSnapshot;
+        processor.stateFormat.read(expected.binary.getData(), expected.binary.getSize(), expectedSnapshot);
+        processor.stateFormat.read(actual.binary.getData(), actual.binary.getSize(), actualSnapshot);
+        if (expectedSnapshot.extensions.size() != actualSnapshot.extensions.size())
+            return juce::String(actualSnapshot.extensions.size()) + " extension chunks instead of "
+                   + juce::String(expectedSnapshot.extensions.size());
+
+        for (size_t i = 0; i < expectedSnapshot.extensions.size(); ++i)
+            if (expectedSnapshot.extensions[i].id != actualSnapshot.extensions[i].id
+                || expectedSnapshot.extensions[i].data != actualSnapshot.extensions[i].data)
+                return "extension chunk " + juce::String(static_cast<int>(i)) + " differs";
+
+        if (sameBytes && expected.binary != actual.binary)
+            return "saves back to different bytes";
+
+        return {};
+    }
+
+    void runCheckState(const juce::ArgumentList&)
+    {
+        OrbitXAudioProcessor source;
+
+        // Spread the values over each range, snapped to what the parameter can hold.
+        const auto& parameters = source.stateFormat.getParameters();
+        for (size_t i = 0; i < parameters.size(); ++i)
+        {
+            const float spread = std::fmod(0.37f + 0.23f * static_cast<float>(i), 1.0f);
+            parameters[i]->setValueNotifyingHost(parameters[i]->convertTo0to1(parameters[i]->convertFrom0to1(spread)));
+        }
+        source.apvts.state.setProperty(Service::PresetManager::presetNameProperty, "State check", nullptr);
+
+        // A chunk from some later build, loaded the way a host would hand it back.
+        juce::MemoryBlock withChunk;
+        source.getStateInformation(withChunk);
+        {
+            const char payload[] = "curve:0.25,0.5,1.0";
+            juce::MemoryOutputStream output(withChunk, true);
+            output.writeInt(0x54534554);   // "TEST"
+            output.writeInt(static_cast<int>(sizeof(payload)));
+            output.write(payload, sizeof(payload));
+        }
+        source.setStateInformation(withChunk.getData(), static_cast<int>(withChunk.getSize()));
+
+        const auto expected = saveState(source);
+        bool passed = true;
+        auto report = [&passed](const juce::String& name, const juce::String& problem)
+        {
+            std::cout << "  " << name.paddedRight(' ', 22) << (problem.isEmpty() ? "ok" : problem) << std::endl;
+            passed = passed && problem.isEmpty();
+        };
+
+        std::cout << "State round trip, " << parameters.size() << " parameters" << std::endl;
+        report("unknown chunk kept", expected.binary == withChunk ? juce::String() : "saves back to different bytes");
+
+        juce::MemoryBlock xml, stream;
+        const auto xmlText = source.apvts.copyState().createXml()->toString();
+        xml.append(xmlText.toRawUTF8(), xmlText.getNumBytesAsUTF8());
+        {
+            juce::MemoryOutputStream output(stream, false);
+            source.apvts.copyState().writeToStream(output);
+        }
+
+        const std::pair<const char*, const juce::MemoryBlock*> formats[] {
+            { "binary", &expected.binary }, { "preset XML", &xml }, { "ValueTree stream", &stream }
+        };
+
+        for (auto& [name, data] : formats)
+        {
+            OrbitXAudioProcessor restored;
+            restored.setStateInformation(data->getData(), static_cast<int>(data->getSize()));
+            report(name, compareStates(restored, expected, saveState(restored), data == &expected.binary));
+        }
+
+        if (! passed)
+            juce::ConsoleApplication::fail("State round-trip check failed");
+    }
+
+    void runCalibrate(const juce::ArgumentList& args)
+    {
+        const JackDistortion::Loudness::CalibrationOptions options;
+        const auto source = JackDistortion::Loudness::formatTableSource(JackDistortion::Loudness::calibrate(options), options);
+
+        if (args.size() < 2)
+        {
+            std::cout << source;
+            return;
+        }
+
+        auto file = args[1].resolveAsFile();
+        if (! file.replaceWithText(source))
+            juce::ConsoleApplication::fail("Could not write " + file.getFullPathName());
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    // The processor's parameter state relies on a message manager being present.
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::ConsoleApplication app;
+    app.addHelpCommand("--help|-h", "Usage:", true);
+
+    app.addCommand({ "--render",
+                     "--render [--preset file.preset] [--set ID=value]... [--quality Eco|Normal|HQ] "
+                     "[--block-size n] [--jobs n] [--output dir] files...",
+                     "Renders WAV/AIFF files through the processor.",
+                     "Files are processed in parallel, one processor instance per worker thread. "
+                     "Overrides are applied after the preset; choice parameters take their item text or index. "
+                     "Renders keep the input's file name, so inputs need distinct names and must not be in the output directory.",
+                     runRender });
+
+    app.addCommand({ "--benchmark",
+                     "--benchmark [--blocks n] [--isa SSE2|AVX2|AVX-512]",
+                     "Prints the per-algorithm microbenchmark and the approximation tier report.",
+                     "The report names the kernel path in use; --isa forces a narrower one.",
+                     runBenchmark });
+
+    app.addCommand({ "--instantiation",
+                     "--instantiation [--cycles n] [--budget ms]",
+                     "Times constructing, preparing, running one block through and destroying the processor.",
+                     "Fails if the median or the first cycle takes longer than the budget (10 ms by default).",
+                     runInstantiationBenchmark });
+
+    app.addCommand({ "--scale-image",
+                     "--scale-image source width height output.png",
+                     "Writes a copy of an image scaled to the given size, for the pre-scaled editor assets.",
+                     "The title is drawn at 192x108: make Assets/titleShine_1x.png at that size and "
+                     "titleShine_2x.png at 384x216 from Artwork/titleShine.png.",
+                     runScaleImage });
+
+    app.addCommand({ "--write-golden",
+                     "--write-golden dir",
+                     "Renders the golden-output cases into a reference directory.",
+                     "The committed set is Tools/OrbitXRender/Golden, written from a scalar (SSE2) build; "
+                     "rewrite it from one when a change is meant to alter the output.",
+                     runWriteGolden });
+
+    app.addCommand({ "--check-golden",
+                     "--check-golden dir",
+                     "Checks the current build against a reference directory.",
+                     "Use Tools/OrbitXRender/Golden; the tolerances allow for the AVX2 and AVX-512 kernel paths.",
+                     runCheckGolden });
+
+    app.addCommand({ "--check-state",
+                     "--check-state",
+                     "Saves a state in the binary, preset XML and ValueTree stream formats and loads each back.",
+                     "Fails if a parameter value, a state property or an unknown extension chunk does not "
+                     "survive, or if a binary state does not save back to the same bytes.",
+                     runCheckState });
+
+    app.addCommand({ "--calibrate",
+                     "--calibrate [LoudnessCompensationTable.h]",
+                     "Measures every algorithm across the drive range and writes the loudness compensation table.",
+                     "Without a file the generated source is printed. Re-run after changing any curve.",
+                     runCalibrate });
+
+    return app.findAndRunCommand(argc, argv);
+}
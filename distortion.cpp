@@ -9,3 +9,101 @@
 */
 
 #include "distortion.h"
+
+namespace JackDistortion {
+
+namespace
+{
+    template <size_t... Indices>
+    void emplaceByIndex(AnyDistortion& slot, int index, std::index_sequence<Indices...>)
+    {
+        using Emplacer = void (*)(AnyDistortion&);
+        static const Emplacer emplacers[] = { [](AnyDistortion& v) { v.emplace<Indices>(); }... };
+        emplacers[index](slot);
+    }
+
+    struct RegistryEntry
+    {
+        const char* name;
+        AliasingClass aliasing;
+        bool stateful = false;      // keeps state from sample to sample
+    };
+
+    // One entry per AnyDistortion alternative, in the same order.
+    constexpr RegistryEntry registry[] =
+    {
+        { "Soft Clip",           AliasingClass::heavy },    // the analog offset steps at every zero crossing
+        { "Hard Clip",           AliasingClass::heavy },
+        { "Sinusoidal Fold",     AliasingClass::heavy },
+        { "Wave Shaped",         AliasingClass::moderate }, // cubic: harmonics up to the 3rd
+        { "Arctan",              AliasingClass::heavy },    // k = 20 is close to a hard clip
+        { "Asymmetrical Arctan", AliasingClass::heavy },
+        { "Cascade",             AliasingClass::mild },
+        { "Polynomial",          AliasingClass::moderate },
+        { "Rectify",             AliasingClass::heavy },    // kink at zero
+        { "Logarithmic",         AliasingClass::mild },
+        { "Bitcrusher",          AliasingClass::heavy },
+        { "Cubic",               AliasingClass::moderate }, // 5th order polynomial
+        { "Diode",               AliasingClass::moderate },
+        { "Tube",                AliasingClass::moderate },
+        { "Chebyshev",           AliasingClass::heavy },    // gate step at |x| = 0.01 and the clamp
+        { "Lofi",                AliasingClass::intended, true }, // the hold divider counts base-rate samples
+        { "Wavefolder",          AliasingClass::heavy },
+    };
+
+    static_assert(std::size(registry) == numAlgorithms, "registry entries must match AnyDistortion");
+    static_assert(registry[15].stateful && std::is_same_v<std::variant_alternative_t<15, AnyDistortion>, lofi>,
+                  "lofi's registry entry must be flagged stateful");
+}
+
+const juce::StringArray& getAlgorithmNames()
+{
+    static const juce::StringArray names = []
+    {
+        juce::StringArray result;
+        for (auto& entry : registry)
+            result.add(entry.name);
+        return result;
+    }();
+    return names;
+}
+
+AliasingClass getAliasingClass(int index)
+{
+    return registry[juce::jlimit(0, numAlgorithms - 1, index)].aliasing;
+}
+
+int getOversamplingFactorLog2(AliasingClass aliasing, int tierOffset)
+{
+    switch (aliasing)
+    {
+        case AliasingClass::mild:     return 0 + tierOffset;
+        case AliasingClass::moderate: return 1 + tierOffset;
+        case AliasingClass::heavy:    return 2 + tierOffset;
+        case AliasingClass::intended: return 0;
+    }
+    return 0;
+}
+
+bool isStateful(int index)
+{
+    return registry[juce::jlimit(0, numAlgorithms - 1, index)].stateful;
+}
+
+AnyDistortion makeDistortion(int index)
+{
+    AnyDistortion result;
+    emplaceDistortion(result, index);
+    return result;
+}
+
+void emplaceDistortion(AnyDistortion& slot, int index)
+{
+    index = juce::jlimit(0, numAlgorithms - 1, index);
+    if (static_cast<int>(slot.index()) == index)
+        return;
+
+    emplaceByIndex(slot, index, std::make_index_sequence<numAlgorithms>{});
+}
+
+} // namespace JackDistortion
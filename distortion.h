@@ -1,6 +1,9 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <type_traits>
+#include "KernelDispatch.h"
+#include <variant>
 
 namespace JackDistortion {
 
@@ -17,6 +20,14 @@ public:
     virtual float getCompensation() const { return 1.0f; }
 };
 
+/** True for algorithms with a vectorised processSamples(float*, int). */
+template <typename Distortion, typename = void>
+struct HasVectorKernel : std::false_type {};
+
+template <typename Distortion>
+struct HasVectorKernel<Distortion, std::void_t<decltype(std::declval<Distortion&>().processSamples(std::declval<float*>(), 0))>>
+    : std::true_type {};
+
 //------------------------------------------------------------------------------------------------------------//
 // Analog Clip Distortion (Ableton saturator copy attempt)
 class softClip : public DistortionBase {
@@ -81,6 +92,13 @@ public:
             return drivenSample * outputGain;
     }
 
+    void processSamples(float* data, int numSamples) {
+        const float driveGain  = juce::Decibels::decibelsToGain(Drive);
+        const float outputGain = juce::Decibels::decibelsToGain(Output) / getCompensation();
+        const float limit      = threshold;
+        Kernels::mapSamples(data, numSamples, [=](auto x) { return Kernels::laneClamp(x * driveGain, -limit, limit) * outputGain; });
+    }
+
 private:
     float Drive = 22.0f, Output = 10.0f;
     float threshold = 0.1f;
@@ -140,6 +158,13 @@ public:
         return result * outputGain;
     }
 
+    void processSamples(float* data, int numSamples) {
+        const float driveGain  = juce::Decibels::decibelsToGain(Drive);
+        const float outputGain = juce::Decibels::decibelsToGain(Output) / getCompensation();
+        const float cubeGain   = Shape * 1.2f;
+        Kernels::mapSamples(data, numSamples, [=](auto x) { x = x * driveGain; return (x - x * x * x * cubeGain) * outputGain; });
+    }
+
 private:
     float Drive = 7.0f, Output = 0.0f, Shape = 0.9f;
 };
@@ -262,6 +287,13 @@ public:
         return result * outputGain;
     }
 
+    void processSamples(float* data, int numSamples) {
+        const float driveGain  = juce::Decibels::decibelsToGain(Drive);
+        const float outputGain = juce::Decibels::decibelsToGain(Output) / getCompensation();
+        const float a = paramA * 1.3f, b = paramB * 1.3f;
+        Kernels::mapSamples(data, numSamples, [=](auto x) { x = x * driveGain; const auto x2 = x * x; return (x - x2 * a - x2 * x * b) * outputGain; });
+    }
+
 private:
     float Drive = 5.0f, Output = 0.0f;
     float paramA = 0.25f, paramB = 0.75f;
@@ -291,6 +323,12 @@ public:
         return std::abs(x) * outputGain;
     }
 
+    void processSamples(float* data, int numSamples) {
+        const float driveGain  = juce::Decibels::decibelsToGain(Drive);
+        const float outputGain = juce::Decibels::decibelsToGain(Output) / getCompensation();
+        Kernels::mapSamples(data, numSamples, [=](auto x) { return Kernels::laneAbs(x * driveGain) * outputGain; });
+    }
+
 private:
     float Drive = 10.0f, Output = 2.0f;
 };
@@ -383,6 +421,16 @@ public:
         return result * outputGain;
     }
 
+    void processSamples(float* data, int numSamples) {
+        const float driveGain  = juce::Decibels::decibelsToGain(Drive);
+        const float outputGain = juce::Decibels::decibelsToGain(Output) / getCompensation();
+        Kernels::mapSamples(data, numSamples, [=](auto x) {
+            x = x * driveGain;
+            const auto x2 = x * x, x3 = x2 * x;
+            return (x - x3 * (1.0f / 3.0f) + x3 * x2 * (1.0f / 5.0f)) * outputGain;
+        });
+    }
+
 private:
     float Drive = 12.0f, Output = 0.0f;
 };
@@ -440,6 +488,12 @@ public:
         return result * outputGain;
     }
 
+    void processSamples(float* data, int numSamples) {
+        const float driveGain  = juce::Decibels::decibelsToGain(Drive);
+        const float outputGain = juce::Decibels::decibelsToGain(Output); // no compensation
+        Kernels::mapSamples(data, numSamples, [=](auto x) { x = x * driveGain; return (x * 1.5f - x * x * x * 0.5f) * outputGain; });
+    }
+
 private:
     float Drive = 8.0f, Output = 0.0f;
 };
@@ -485,10 +539,11 @@ private:
 // Lofi Distortion (sample rate reduction)
 class lofi : public DistortionBase {
 public:
+    // Called every block, so the hold phase is left alone here: it runs on across block edges and
+    // only starts over when the processor builds a fresh engine on reset.
     void setParameters(float drive, float output) override {
         Drive = drive;
         Output = output;
-        counter = 0;
     }
 
     float getCompensation() const override { return 1.0f; }
@@ -513,7 +568,7 @@ private:
     float Drive = 0.0f, Output = 0.0f;
     float lastSample = 0.0f;
     int counter = 0;
-    const int rateDivider = 8;
+    static constexpr int rateDivider = 8;
 };
 
 //------------------------------------------------------------------------------------------------------------//
@@ -545,6 +600,47 @@ private:
     float Drive = 15.0f, Output = 7.0f;
 };
 
+//------------------------------------------------------------------------------------------------------------//
+// Algorithm registry
+//
+// Every algorithm in one closed set, indexed by (algorithm ID - 1) so the order matches the
+// Distortion_* choice parameters. Visiting an AnyDistortion resolves to the concrete class, so
+// processSample is called directly rather than through the base class.
+using AnyDistortion = std::variant<softClip, hardClip, sinusoidalFold, waveShaped, arctan, asym,
+                                   cascade, poly, rectify, logarithmic, bitcrusher, cubic, diode,
+                                   tube, chebyshev, lofi, wavefolder>;
+
+constexpr int numAlgorithms = static_cast<int>(std::variant_size_v<AnyDistortion>);
+
+/** Display names in registry order. */
+const juce::StringArray& getAlgorithmNames();
+
+/** Creates the algorithm at the given registry index (0 .. numAlgorithms - 1). */
+AnyDistortion makeDistortion(int index);
+
+/** How much an algorithm aliases at the base rate, which decides the rate its corner runs at. */
+enum class AliasingClass
+{
+    mild,       // smooth curves, run at the base rate
+    moderate,   // low-order polynomials and soft saturation, 2x
+    heavy,      // hard edges, folds and quantisers, 4x
+    intended    // the aliasing is the effect: the base rate at every quality tier
+};
+
+AliasingClass getAliasingClass(int index);
+
+/** Oversampling factor, as a power of two, for an aliasing class with a quality tier's offset
+    applied. Intended aliasing ignores the offset. */
+int getOversamplingFactorLog2(AliasingClass aliasing, int tierOffset = 0);
+
+/** True for algorithms that keep state from sample to sample (lofi's hold). Each sample must
+    reach them exactly once, so they cannot be run twice over a block. */
+bool isStateful(int index);
+
+/** Re-seats an existing slot in place with the algorithm at the given registry index.
+    Does nothing if the slot already holds that algorithm, so its state is kept. */
+void emplaceDistortion(AnyDistortion& slot, int index);
+
 } // namespace JackDistortion
 
 //------------------------------------------------------------------------------------------------------------//